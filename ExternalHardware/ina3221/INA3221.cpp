@@ -2,25 +2,111 @@
 #include <AbstractPlatform/common/TypeBinaryRepresentation.hpp>
 
 #include <functional>
+#include <limits>
 #include <algorithm>
 
-#define DEVICE_ID 0x40
-#define SIGNATURE 0x3220
-#define REG_DATA_ch1 0x01  // ch 1 shunt
-#define REG_DATA_ch2 0x03  // ch 2 shunt
-#define REG_DATA_ch3 0x05  // ch 3 shunt
-
 namespace ExternalHardware
 {
 namespace
 {
 
-constexpr std::int16_t KFullScaleRegisterValue = 0x0FFF;
+constexpr std::int16_t KFullScaleRegisterValue = CIina3221::KFullScaleCounts;
+
+using TRegisterMap = Ina3221::CRegisterMap;
+
+static constexpr std::uint16_t KDieIdSignature = TRegisterMap::TDieId::KResetValue;
+
+static constexpr std::uint8_t KRegConfig = TRegisterMap::TConfig::KAddress;
+static constexpr std::uint8_t KRegMaskEnable = TRegisterMap::TMaskEnable::KAddress;
+
+// Shunt/bus voltage registers of all channels: ch1 shunt .. ch3 bus
+static constexpr std::uint8_t KRegMeasurementFirst = TRegisterMap::TShuntVoltage::KAddress;
+static constexpr std::uint8_t KMeasurementRegisterNumber = CIina3221::KMeasurementRegisterNumber;
+
+// Shunt voltage sum and sum limit hold their data in bits 14..1
+static constexpr std::uint8_t KSumDataLShift = 1;
+
+static_assert( sizeof( CIina3221::CConfig ) == sizeof( std::uint16_t ), "" );
+static_assert( sizeof( CIina3221::CMaskEnable ) == sizeof( std::uint16_t ), "" );
+static_assert( CIina3221::CConfig{ 0 }
+                       .SetOperationMode( CIina3221::OperationMode::ShuntAndBusVoltageContinuous )
+                       .SetShuntVoltageConversionTime( CIina3221::ConversionTime::t1100us )
+                       .SetBusVoltageConversionTime( CIina3221::ConversionTime::t1100us )
+                       .SetAveragingMode( CIina3221::AveragingMode::avg1 )
+                       .SetChannelEnable( CIina3221::KChannel1, true )
+                       .SetChannelEnable( CIina3221::KChannel2, true )
+                       .SetChannelEnable( CIina3221::KChannel3, true )
+                       .Value( )
+                   == CIina3221::CConfig::KDefault,
+               "" );
+
+constexpr std::uint8_t KChannelNumber = CIina3221::KChannelNumber;
 
-static constexpr std::uint8_t KRegConfig = 0x00;
-static constexpr std::uint8_t KDieId = 0xFF;
+static constexpr std::uint16_t KConfigResetBit = CIina3221::CConfig::TReset::KMask;
+static constexpr std::uint16_t KMaskEnableControlBits = CIina3221::CMaskEnable::KControlMask;
+static constexpr std::uint16_t KMaskEnableCVRFBit = CIina3221::CMaskEnable::TCVRF::KMask;
+
+// Single-shot deadline margin (1/8 of the conversion time) and the shortest CVRF poll, a 3-byte
+// transaction at 3.4 MHz
+static constexpr std::uint32_t KTriggerMarginDivider = 8;
+static constexpr std::uint32_t KMinPollTimeUs = 10;
+
+// Registers held by the shadow cache, indexed by the shadow slot
+static constexpr std::uint8_t KShadowRegisterAddresses[] = {
+    KRegConfig,
+    TRegisterMap::TCriticalAlertLimit::Address( 1 ),
+    TRegisterMap::TWarningAlertLimit::Address( 1 ),
+    TRegisterMap::TCriticalAlertLimit::Address( 2 ),
+    TRegisterMap::TWarningAlertLimit::Address( 2 ),
+    TRegisterMap::TCriticalAlertLimit::Address( 3 ),
+    TRegisterMap::TWarningAlertLimit::Address( 3 ),
+    TRegisterMap::TShuntVoltageSumLimit::KAddress,
+    KRegMaskEnable,
+    TRegisterMap::TPowerValidUpperLimit::KAddress,
+    TRegisterMap::TPowerValidLowerLimit::KAddress,
+};
+
+// Power-on values of the shadowed registers, indexed by the shadow slot
+static constexpr std::uint16_t KShadowRegisterResetValues[] = {
+    TRegisterMap::TConfig::KResetValue,
+    TRegisterMap::TCriticalAlertLimit::KResetValue,
+    TRegisterMap::TWarningAlertLimit::KResetValue,
+    TRegisterMap::TCriticalAlertLimit::KResetValue,
+    TRegisterMap::TWarningAlertLimit::KResetValue,
+    TRegisterMap::TCriticalAlertLimit::KResetValue,
+    TRegisterMap::TWarningAlertLimit::KResetValue,
+    TRegisterMap::TShuntVoltageSumLimit::KResetValue,
+    TRegisterMap::TMaskEnable::KResetValue,
+    TRegisterMap::TPowerValidUpperLimit::KResetValue,
+    TRegisterMap::TPowerValidLowerLimit::KResetValue,
+};
+static_assert( sizeof( KShadowRegisterResetValues ) / sizeof( std::uint16_t )
+                   == sizeof( KShadowRegisterAddresses ),
+               "" );
+
+static constexpr std::uint8_t KNoShadowSlot = 0xFF;
+
+constexpr std::uint8_t
+ShadowSlot( std::uint8_t aRegisterAddress ) NOEXCEPT
+{
+    for ( std::uint8_t slot = 0; slot < sizeof( KShadowRegisterAddresses ); ++slot )
+    {
+        if ( KShadowRegisterAddresses[ slot ] == aRegisterAddress )
+        {
+            return slot;
+        }
+    }
+    return KNoShadowSlot;
+}
 
-constexpr std::uint8_t KChannelNumber = 3;
+// Strips the bits the device changes on its own (reset bit, mask/enable flags)
+constexpr std::uint16_t
+ShadowValue( std::uint8_t aRegisterAddress, std::uint16_t aRegisterValue ) NOEXCEPT
+{
+    return aRegisterAddress == KRegConfig       ? aRegisterValue & ~KConfigResetBit
+           : aRegisterAddress == KRegMaskEnable ? aRegisterValue & KMaskEnableControlBits
+                                                : aRegisterValue;
+}
 
 template < class taValue, class taCompare = std::less< taValue > >
 constexpr const taValue&
@@ -29,25 +115,19 @@ Clamp( const taValue& aValue, const taValue& aLo, const taValue& aHi, taCompare
     return aComp( aValue, aLo ) ? aLo : aComp( aHi, aValue ) ? aHi : aValue;
 }
 
-inline std::uint16_t
+inline constexpr std::uint16_t
 ToTwosComplement( std::int16_t aValue ) NOEXCEPT
 {
-    if ( aValue < 0 )
-    {
-        return 0x8000 | static_cast< std::uint16_t >( -aValue );
-    }
-
     return static_cast< std::uint16_t >( aValue );
 }
 
-inline std::int16_t
+inline constexpr std::int16_t
 FromTwosComplement( std::uint16_t aTwosComplementValue ) NOEXCEPT
 {
-    if ( aTwosComplementValue >= 0x8000 )
-    {
-        aTwosComplementValue = -static_cast< std::int16_t >( 0x7FFF & aTwosComplementValue );
-    }
-    return aTwosComplementValue;
+    return aTwosComplementValue >= 0x8000
+               ? static_cast< std::int16_t >( static_cast< std::int32_t >( aTwosComplementValue )
+                                              - 0x10000 )
+               : static_cast< std::int16_t >( aTwosComplementValue );
 }
 
 std::uint32_t
@@ -67,124 +147,100 @@ ChangeEndian( std::uint16_t x ) NOEXCEPT
     return x;
 }
 
+// Signed full-scale-relative register counts: -KFullScaleRegisterValue..KFullScaleRegisterValue
 template < std::uint8_t taDataLShift = 3 >
-float
-BusRegisterToVoltage( std::uint16_t aVoltageRegister,
-                      float aFullScaleAbsoluteVoltage,
-                      std::int16_t aFullScaleRegisterValue = KFullScaleRegisterValue ) NOEXCEPT
+inline constexpr std::int16_t
+RegisterToCounts( std::uint16_t aVoltageRegister ) NOEXCEPT
 {
     constexpr uint16_t mask = static_cast< std::uint16_t >( 0xFFFF_u16 << taDataLShift );
     constexpr int16_t divider = 1 << taDataLShift;
 
-    const auto rawVoltage = FromTwosComplement( aVoltageRegister & mask ) / divider;
-    const float voltage = aFullScaleAbsoluteVoltage * rawVoltage / aFullScaleRegisterValue;
-    return voltage;
+    return FromTwosComplement( aVoltageRegister & mask ) / divider;
 }
 
 template < std::uint8_t taDataLShift = 3 >
-std::uint16_t
-VoltageToBusRegister( float aVoltage,
-                      float aFullScaleAbsoluteVoltage,
-                      std::int16_t aFullScaleRegisterValue = KFullScaleRegisterValue ) NOEXCEPT
+inline constexpr std::uint16_t
+CountsToRegister( std::int16_t aCounts ) NOEXCEPT
 {
     constexpr uint16_t mask = static_cast< std::uint16_t >( 0xFFFF_u16 << taDataLShift );
     constexpr int16_t multiplier = 1 << taDataLShift;
 
-    aVoltage = Clamp( aVoltage, -aFullScaleAbsoluteVoltage, aFullScaleAbsoluteVoltage )
-               * aFullScaleRegisterValue / aFullScaleAbsoluteVoltage;
-    const auto rawVoltage = static_cast< std::int16_t >( aVoltage );
-    return ToTwosComplement( rawVoltage * multiplier ) & mask;
+    aCounts = Clamp< std::int16_t >( aCounts, -KFullScaleRegisterValue, KFullScaleRegisterValue );
+    return ToTwosComplement( aCounts * multiplier ) & mask;
 }
 
-std::uint16_t
-PackConfig( const CIina3221::CConfig& aConfig ) NOEXCEPT
-{
-    std::uint16_t result = 0x0000;
-    result |= static_cast< std::uint16_t >( aConfig.iOperationMode );
-    result |= static_cast< std::uint16_t >( aConfig.iShuntVoltageConversionTime ) << 3;
-    result |= static_cast< std::uint16_t >( aConfig.iBusVoltageConversionTime ) << 6;
-    result |= static_cast< std::uint16_t >( aConfig.iAveragingMode ) << 9;
-    result |= static_cast< std::uint16_t >( aConfig.iChannel3Enable ) << 12;
-    result |= static_cast< std::uint16_t >( aConfig.iChannel2Enable ) << 13;
-    result |= static_cast< std::uint16_t >( aConfig.iChannel1Enable ) << 14;
-    result |= static_cast< std::uint16_t >( aConfig.iRstart ) << 15;
+template < std::int32_t taFullScaleMicroVolts >
+struct CMicroVoltScale
+{
+    static constexpr std::int32_t KLsbMicroVolts = taFullScaleMicroVolts / KFullScaleRegisterValue;
+    static_assert( KLsbMicroVolts * KFullScaleRegisterValue == taFullScaleMicroVolts,
+                   "Full scale must be an integer multiple of the register LSB" );
+};
 
-    return result;
+template < std::uint8_t taDataLShift, std::int32_t taFullScaleMicroVolts >
+inline constexpr std::int32_t
+RegisterToMicroVolts( std::uint16_t aVoltageRegister ) NOEXCEPT
+{
+    return RegisterToCounts< taDataLShift >( aVoltageRegister )
+           * CMicroVoltScale< taFullScaleMicroVolts >::KLsbMicroVolts;
 }
 
-void
-UnpackConfig( CIina3221::CConfig& aConfig, std::uint16_t aPackedConfig ) NOEXCEPT
+template < std::uint8_t taDataLShift, std::int32_t taFullScaleMicroVolts >
+inline constexpr std::uint16_t
+MicroVoltsToRegister( std::int32_t aMicroVolts ) NOEXCEPT
 {
-    aConfig.iOperationMode = static_cast< CIina3221::OperationMode >( aPackedConfig & 0x7 );
-    aConfig.iShuntVoltageConversionTime
-        = static_cast< CIina3221::ConversionTime >( ( aPackedConfig >> KChannelNumber ) & 0x7 );
-    aConfig.iBusVoltageConversionTime
-        = static_cast< CIina3221::ConversionTime >( ( aPackedConfig >> 6 ) & 0x7 );
-    aConfig.iAveragingMode
-        = static_cast< CIina3221::AveragingMode >( ( aPackedConfig >> 9 ) & 0x7 );
-    aConfig.iChannel3Enable = static_cast< bool >( ( aPackedConfig >> 12 ) & 0x1 );
-    aConfig.iChannel2Enable = static_cast< bool >( ( aPackedConfig >> 13 ) & 0x1 );
-    aConfig.iChannel1Enable = static_cast< bool >( ( aPackedConfig >> 14 ) & 0x1 );
-    aConfig.iRstart = static_cast< bool >( ( aPackedConfig >> 15 ) & 0x1 );
+    aMicroVolts = Clamp( aMicroVolts, -taFullScaleMicroVolts, taFullScaleMicroVolts );
+    return CountsToRegister< taDataLShift >( static_cast< std::int16_t >(
+        aMicroVolts / CMicroVoltScale< taFullScaleMicroVolts >::KLsbMicroVolts ) );
 }
 
-std::uint16_t
-PackMaskEnable( const CIina3221::CMaskEnable& aMaskEnable ) NOEXCEPT
-{
-    std::uint16_t result = 0x0000;
-    result |= static_cast< std::uint16_t >( aMaskEnable.iCVRF );
-    result |= static_cast< std::uint16_t >( aMaskEnable.iTCF ) << 1;
-    result |= static_cast< std::uint16_t >( aMaskEnable.iPVF ) << 2;
-    result |= static_cast< std::uint16_t >( aMaskEnable.iWF3 ) << 3;
-    result |= static_cast< std::uint16_t >( aMaskEnable.iWF2 ) << 4;
-    result |= static_cast< std::uint16_t >( aMaskEnable.iWF1 ) << 5;
-    result |= static_cast< std::uint16_t >( aMaskEnable.iSF ) << 6;
-    result |= static_cast< std::uint16_t >( aMaskEnable.iCF3 ) << 7;
-    result |= static_cast< std::uint16_t >( aMaskEnable.iCF2 ) << 8;
-    result |= static_cast< std::uint16_t >( aMaskEnable.iCF1 ) << 9;
-    result |= static_cast< std::uint16_t >( aMaskEnable.iCEN ) << 10;
-    result |= static_cast< std::uint16_t >( aMaskEnable.iWEN ) << 11;
-    result |= static_cast< std::uint16_t >( aMaskEnable.iSSC3 ) << 12;
-    result |= static_cast< std::uint16_t >( aMaskEnable.iSSC2 ) << 13;
-    result |= static_cast< std::uint16_t >( aMaskEnable.iSSC1 ) << 14;
+static_assert( RegisterToMicroVolts< 3, CIina3221::KMaxShuntVoltageUv >( 0x7FF8 ) == 163800, "" );
+static_assert( RegisterToMicroVolts< 3, CIina3221::KMaxBusVoltageUv >( 0x0008 ) == 8000, "" );
+static_assert( MicroVoltsToRegister< 3, CIina3221::KMaxShuntVoltageUv >( -40 ) == 0xFFF8, "" );
+static_assert( RegisterToMicroVolts< 3, CIina3221::KMaxShuntVoltageUv >( 0x8008 ) == -163800, "" );
 
-    return result;
+static constexpr float KMicroVoltsPerVolt = 1e6f;
+
+// Float values are the integer decode scaled to volts, so the float and microvolt APIs agree
+template < std::uint8_t taDataLShift, std::int32_t taFullScaleMicroVolts >
+inline float
+RegisterToVolts( std::uint16_t aVoltageRegister ) NOEXCEPT
+{
+    return static_cast< float >(
+               RegisterToMicroVolts< taDataLShift, taFullScaleMicroVolts >( aVoltageRegister ) )
+           * CIina3221::KVoltsPerMicroVolt;
 }
 
-void
-UnpackMaskEnable( CIina3221::CMaskEnable& aMaskEnable, std::uint16_t aPackedMaskEnable ) NOEXCEPT
+// Nearest integer of a value within the std::int32_t range
+inline std::int32_t
+RoundToInt32( float aValue ) NOEXCEPT
+{
+    return static_cast< std::int32_t >( aValue < 0.0f ? aValue - 0.5f : aValue + 0.5f );
+}
+
+// Rounds to the nearest microvolt and encodes that with MicroVoltsToRegister
+template < std::uint8_t taDataLShift, std::int32_t taFullScaleMicroVolts >
+inline std::uint16_t
+VoltsToRegister( float aVoltage ) NOEXCEPT
 {
-    aMaskEnable.iCVRF = static_cast< bool >( aPackedMaskEnable & 0x1 );
-    aMaskEnable.iTCF = static_cast< bool >( aPackedMaskEnable >> 1 & 0x1 );
-    aMaskEnable.iPVF = static_cast< bool >( aPackedMaskEnable >> 2 & 0x1 );
-    aMaskEnable.iWF3 = static_cast< bool >( aPackedMaskEnable >> 3 & 0x1 );
-    aMaskEnable.iWF2 = static_cast< bool >( aPackedMaskEnable >> 4 & 0x1 );
-    aMaskEnable.iWF1 = static_cast< bool >( aPackedMaskEnable >> 5 & 0x1 );
-    aMaskEnable.iSF = static_cast< bool >( aPackedMaskEnable >> 6 & 0x1 );
-    aMaskEnable.iCF3 = static_cast< bool >( aPackedMaskEnable >> 7 & 0x1 );
-    aMaskEnable.iCF2 = static_cast< bool >( aPackedMaskEnable >> 8 & 0x1 );
-    aMaskEnable.iCF1 = static_cast< bool >( aPackedMaskEnable >> 9 & 0x1 );
-    aMaskEnable.iCEN = static_cast< bool >( aPackedMaskEnable >> 10 & 0x1 );
-    aMaskEnable.iWEN = static_cast< bool >( aPackedMaskEnable >> 11 & 0x1 );
-    aMaskEnable.iSSC3 = static_cast< bool >( aPackedMaskEnable >> 12 & 0x1 );
-    aMaskEnable.iSSC2 = static_cast< bool >( aPackedMaskEnable >> 13 & 0x1 );
-    aMaskEnable.iSSC1 = static_cast< bool >( aPackedMaskEnable >> 14 & 0x1 );
+    constexpr float KFullScale = static_cast< float >( taFullScaleMicroVolts );
+    const float microVolts = Clamp( aVoltage * KMicroVoltsPerVolt, -KFullScale, KFullScale );
+    return MicroVoltsToRegister< taDataLShift, taFullScaleMicroVolts >(
+        RoundToInt32( microVolts ) );
 }
 
-inline CIina3221::CConfig
-UnpackConfig( std::uint16_t aPackedConfig ) NOEXCEPT
+// Rejects NaN as well
+inline bool
+IsCalibrationGain( float aGain ) NOEXCEPT
 {
-    CIina3221::CConfig config;
-    UnpackConfig( config, aPackedConfig );
-    return config;
+    return aGain > 0.0f && aGain <= CIina3221::KMaxCalibrationGain;
 }
 
-inline constexpr std::uint8_t
-MultiRegisterAddress( std::uint8_t aOffset,
-                      std::uint8_t aPeriod,
-                      std::uint8_t aRegisterNumber ) NOEXCEPT
+inline bool
+IsCalibrationOffset( float aOffset, std::int32_t aFullScaleMicroVolts ) NOEXCEPT
 {
-    return aOffset + ( aPeriod * ( aRegisterNumber - 1 ) );
+    const float fullScale = static_cast< float >( aFullScaleMicroVolts );
+    return aOffset * KMicroVoltsPerVolt >= -fullScale && aOffset * KMicroVoltsPerVolt <= fullScale;
 }
 
 }  // namespace
@@ -194,10 +250,17 @@ CIina3221::TErrorCode
 CIina3221::ReadRegister( std::uint8_t aRegisterAddress, taRegisterType& aRegisterValue ) NOEXCEPT
 {
     using namespace AbstractPlatform;
+#ifdef INA3221_INSTRUMENTATION
+    const auto startNs = iInstrumentation.Now( );
+#endif
+    const bool pointerReuse = aRegisterAddress == iLastRegisterAddress;
     const auto result
-        = aRegisterAddress == iLastRegisterAddress
+        = pointerReuse
               ? iI2CBus.ReadLastRegisterRaw( iDeviceAddress, aRegisterValue )
               : iI2CBus.ReadRegisterRaw( iDeviceAddress, aRegisterAddress, aRegisterValue );
+#ifdef INA3221_INSTRUMENTATION
+    iInstrumentation.RecordRead( aRegisterAddress, 1, pointerReuse, result, startNs );
+#endif
     if ( result )
     {
         iLastRegisterAddress = aRegisterAddress;
@@ -215,8 +278,14 @@ CIina3221::WriteRegister( std::uint8_t aRegisterAddress, taRegisterType aRegiste
     using namespace AbstractPlatform;
     aRegisterValue
         = EndiannessConverter< Endianness::Big, Endianness::Native >::Convert( aRegisterValue );
+#ifdef INA3221_INSTRUMENTATION
+    const auto startNs = iInstrumentation.Now( );
+#endif
     const auto result
         = iI2CBus.WriteRegisterRaw( iDeviceAddress, aRegisterAddress, aRegisterValue );
+#ifdef INA3221_INSTRUMENTATION
+    iInstrumentation.RecordWrite( aRegisterAddress, result, startNs );
+#endif
     if ( result )
     {
         iLastRegisterAddress = aRegisterAddress;
@@ -226,11 +295,150 @@ CIina3221::WriteRegister( std::uint8_t aRegisterAddress, taRegisterType aRegiste
 }
 
 CIina3221::TErrorCode
-CIina3221::Init( const CConfig& aConfig ) NOEXCEPT
+CIina3221::ReadRegisterBlock( std::uint8_t aFirstRegisterAddress,
+                              std::uint16_t* aRegisterValues,
+                              std::size_t aRegisterCount ) NOEXCEPT
+{
+    using namespace AbstractPlatform;
+    if ( aRegisterCount == 0 || aRegisterCount > 0xFF
+         || aFirstRegisterAddress + aRegisterCount > 0x100 )
+    {
+        return AbstractPlatform::KInvalidArgumentError;
+    }
+#ifdef INA3221_INSTRUMENTATION
+    const auto startNs = iInstrumentation.Now( );
+#endif
+    // Pointer write with repeated start unless the pointer is already there, then the device
+    // auto-increments through the registers
+    const bool pointerReuse = aFirstRegisterAddress == iLastRegisterAddress;
+    const std::size_t size = aRegisterCount * sizeof( std::uint16_t );
+    const bool result
+        = ( pointerReuse
+            || iRawI2CBus.Write( iDeviceAddress, &aFirstRegisterAddress, 1, true ) == 1 )
+          && iRawI2CBus.Read(
+                 iDeviceAddress, reinterpret_cast< std::uint8_t* >( aRegisterValues ), size, false )
+                 == static_cast< int >( size );
+#ifdef INA3221_INSTRUMENTATION
+    iInstrumentation.RecordRead( aFirstRegisterAddress,
+                                 static_cast< std::uint8_t >( aRegisterCount ),
+                                 pointerReuse,
+                                 result,
+                                 startNs );
+#endif
+    if ( result )
+    {
+        iLastRegisterAddress = aFirstRegisterAddress;
+        for ( std::size_t index = 0; index < aRegisterCount; ++index )
+        {
+            aRegisterValues[ index ]
+                = EndiannessConverter< Endianness::Native, Endianness::Big >::Convert(
+                    aRegisterValues[ index ] );
+        }
+        return AbstractPlatform::KOk;
+    }
+    return AbstractPlatform::KGenericError;
+}
+
+void
+CIina3221::UpdateShadow( std::uint8_t aRegisterAddress, std::uint16_t aRegisterValue ) NOEXCEPT
+{
+    static_assert( sizeof( KShadowRegisterAddresses ) == KShadowRegisterNumber, "" );
+
+    const auto slot = ShadowSlot( aRegisterAddress );
+    if ( slot != KNoShadowSlot )
+    {
+        iShadowRegisters[ slot ] = ShadowValue( aRegisterAddress, aRegisterValue );
+        iShadowValidMask |= 1 << slot;
+    }
+}
+
+CIina3221::TErrorCode
+CIina3221::ReadShadowedRegister( std::uint8_t aRegisterAddress,
+                                 std::uint16_t& aRegisterValue ) NOEXCEPT
+{
+    const auto slot = ShadowSlot( aRegisterAddress );
+    // Mask/enable flags are volatile and cleared on read, so that register always hits the bus
+    if ( iShadowCacheEnabled && slot != KNoShadowSlot && aRegisterAddress != KRegMaskEnable
+         && ( iShadowValidMask & ( 1 << slot ) ) )
+    {
+        aRegisterValue = iShadowRegisters[ slot ];
+        return AbstractPlatform::KOk;
+    }
+
+    const auto result = ReadRegister( aRegisterAddress, aRegisterValue );
+    if ( result == AbstractPlatform::KOk && iShadowCacheEnabled )
+    {
+        UpdateShadow( aRegisterAddress, aRegisterValue );
+    }
+    return result;
+}
+
+CIina3221::TErrorCode
+CIina3221::WriteShadowedRegister( std::uint8_t aRegisterAddress,
+                                  std::uint16_t aRegisterValue ) NOEXCEPT
+{
+    if ( !iShadowCacheEnabled )
+    {
+        return WriteRegister( aRegisterAddress, aRegisterValue );
+    }
+
+    const bool isReset
+        = aRegisterAddress == KRegConfig && ( aRegisterValue & KConfigResetBit ) != 0;
+    const auto slot = ShadowSlot( aRegisterAddress );
+    if ( !isReset && slot != KNoShadowSlot && ( iShadowValidMask & ( 1 << slot ) )
+         && iShadowRegisters[ slot ] == ShadowValue( aRegisterAddress, aRegisterValue ) )
+    {
+        return AbstractPlatform::KOk;
+    }
+
+    const auto result = WriteRegister( aRegisterAddress, aRegisterValue );
+    if ( isReset )
+    {
+        // Reset restores every register to its default
+        Invalidate( );
+    }
+    else if ( result == AbstractPlatform::KOk )
+    {
+        UpdateShadow( aRegisterAddress, aRegisterValue );
+    }
+    else if ( slot != KNoShadowSlot )
+    {
+        // The register state is unknown after a failed write
+        iShadowValidMask &= ~( 1 << slot );
+    }
+    return result;
+}
+
+void
+CIina3221::EnableShadowCache( bool aEnable ) NOEXCEPT
+{
+    iShadowCacheEnabled = aEnable;
+    Invalidate( );
+}
+
+CIina3221::TErrorCode
+CIina3221::Resync( ) NOEXCEPT
+{
+    Invalidate( );
+    for ( const auto registerAddress : KShadowRegisterAddresses )
+    {
+        std::uint16_t registerValue = 0;
+        const auto result = ReadRegister( registerAddress, registerValue );
+        if ( result != AbstractPlatform::KOk )
+        {
+            return result;
+        }
+        UpdateShadow( registerAddress, registerValue );
+    }
+    return AbstractPlatform::KOk;
+}
+
+CIina3221::TErrorCode
+CIina3221::Init( const CConfig& aConfig, InitMode aInitMode ) NOEXCEPT
 {
     std::uint16_t checkVendorId = 0;
     {
-        const auto operationResult = ReadRegister( KDieId, checkVendorId );
+        const auto operationResult = ReadRegister( TRegisterMap::TDieId::KAddress, checkVendorId );
         if ( operationResult != AbstractPlatform::KOk )
         {
             // Unable to communicate
@@ -238,12 +446,23 @@ CIina3221::Init( const CConfig& aConfig ) NOEXCEPT
         }
     }
 
-    if ( checkVendorId != SIGNATURE )
+    if ( checkVendorId != KDieIdSignature )
     {
         // Invalid device vendor
         return AbstractPlatform::KInvalidVendor;
     }
 
+    if ( aInitMode != InitMode::Reset )
+    {
+        bool running = false;
+        const auto operationResult
+            = CheckWarmStart( aConfig, aInitMode == InitMode::WarmStartKeepLimits, running );
+        if ( operationResult != AbstractPlatform::KOk || running )
+        {
+            return operationResult;
+        }
+    }
+
     {
         const auto operationResult = Reset( aConfig );
         if ( operationResult != AbstractPlatform::KOk )
@@ -256,14 +475,54 @@ CIina3221::Init( const CConfig& aConfig ) NOEXCEPT
     return AbstractPlatform::KOk;
 }
 
+CIina3221::TErrorCode
+CIina3221::CheckWarmStart( const CConfig& aConfig, bool aKeepLimits, bool& aRunning ) NOEXCEPT
+{
+    aRunning = false;
+
+    CReadPlan readPlan{ *this };
+    for ( const auto registerAddress : KShadowRegisterAddresses )
+    {
+        readPlan.AddRegister( registerAddress );
+    }
+    const auto result = readPlan.Execute( );
+    if ( result != AbstractPlatform::KOk )
+    {
+        return result;
+    }
+
+    if ( ShadowValue( KRegConfig, readPlan.Value( KRegConfig ) )
+         != ShadowValue( KRegConfig, aConfig.Value( ) ) )
+    {
+        return AbstractPlatform::KOk;
+    }
+    for ( std::uint8_t slot = 0; slot < KShadowRegisterNumber && !aKeepLimits; ++slot )
+    {
+        const auto registerAddress = KShadowRegisterAddresses[ slot ];
+        if ( registerAddress != KRegConfig
+             && ShadowValue( registerAddress, readPlan.Value( registerAddress ) )
+                    != ShadowValue( registerAddress, KShadowRegisterResetValues[ slot ] ) )
+        {
+            return AbstractPlatform::KOk;
+        }
+    }
+
+    for ( const auto registerAddress : KShadowRegisterAddresses )
+    {
+        UpdateShadow( registerAddress, readPlan.Value( registerAddress ) );
+    }
+    aRunning = true;
+    return AbstractPlatform::KOk;
+}
+
 CIina3221::TErrorCode
 CIina3221::GetConfig( CConfig& aConfig ) NOEXCEPT
 {
     std::uint16_t packedConfigRegister = 0x0000;
-    const auto result = ReadRegister( KRegConfig, packedConfigRegister );
+    const auto result = ReadShadowedRegister( KRegConfig, packedConfigRegister );
     if ( result == AbstractPlatform::KOk )
     {
-        UnpackConfig( aConfig, packedConfigRegister );
+        aConfig = CConfig{ packedConfigRegister };
     }
     return result;
 }
@@ -271,231 +530,1040 @@ CIina3221::GetConfig( CConfig& aConfig ) NOEXCEPT
 CIina3221::TErrorCode
 CIina3221::SetConfig( const CConfig& aConfig ) NOEXCEPT
 {
-    const std::uint16_t packedConfigRegister = PackConfig( aConfig );
-    return WriteRegister( KRegConfig, packedConfigRegister );
+    return WriteShadowedRegister( KRegConfig, aConfig.Value( ) );
 }
 
 CIina3221::TErrorCode
 CIina3221::ShuntVoltageV( float& aVoltage, std::uint8_t aChannel ) NOEXCEPT
 {
-    constexpr std::uint8_t KRegisterAddressOffset = 0x01;
-    constexpr std::uint8_t KRegisterPeriod = 2;
-
-    return GetVoltageRegister< KRegisterAddressOffset, KRegisterPeriod >(
-        aVoltage, iMaxShuntVoltage, aChannel );
+    std::int32_t microVolts = 0;
+    const auto result = ShuntVoltageUv( microVolts, aChannel );
+    if ( result == AbstractPlatform::KOk )
+    {
+        aVoltage = static_cast< float >( microVolts ) * KVoltsPerMicroVolt;
+    }
+    return result;
 }
 
 CIina3221::TErrorCode
 CIina3221::BusVoltageV( float& aVoltage, std::uint8_t aChannel ) NOEXCEPT
 {
-    constexpr std::uint8_t KRegisterAddressOffset = 0x02;
-    constexpr std::uint8_t KRegisterPeriod = 2;
-
-    return GetVoltageRegister< KRegisterAddressOffset, KRegisterPeriod >( aVoltage, iMaxBusVoltage,
-                                                                          aChannel );
+    std::int32_t microVolts = 0;
+    const auto result = BusVoltageUv( microVolts, aChannel );
+    if ( result == AbstractPlatform::KOk )
+    {
+        aVoltage = static_cast< float >( microVolts ) * KVoltsPerMicroVolt;
+    }
+    return result;
 }
 
 CIina3221::TErrorCode
-CIina3221::GetShuntCriticalAlertLimit( float& aShuntLimit, std::uint8_t aChannel ) NOEXCEPT
+CIina3221::ShuntVoltageUv( std::int32_t& aMicroVolts, std::uint8_t aChannel ) NOEXCEPT
 {
-    constexpr std::uint8_t KRegisterAddressOffset = 0x07;
-    constexpr std::uint8_t KRegisterPeriod = 2;
+    using TRegister = TRegisterMap::TShuntVoltage;
 
-    return GetVoltageRegister< KRegisterAddressOffset, KRegisterPeriod >(
-        aShuntLimit, KMaxShuntVoltage, aChannel );
+    std::uint16_t voltageRegister = 0;
+    const auto result = GetVoltageRegister< TRegister >( voltageRegister, aChannel );
+    if ( result == AbstractPlatform::KOk )
+    {
+        const auto& scale = iChannelScale[ aChannel - KChannel1 ];
+        aMicroVolts = Calibrate( ShuntRegisterToUv( voltageRegister ),
+                                 scale.iShuntVoltageGain,
+                                 scale.iShuntVoltageOffsetUv );
+    }
+    return result;
 }
 
 CIina3221::TErrorCode
-CIina3221::SetShuntCriticalAlertLimit( float aShuntLimit, std::uint8_t aChannel ) NOEXCEPT
+CIina3221::BusVoltageUv( std::int32_t& aMicroVolts, std::uint8_t aChannel ) NOEXCEPT
 {
-    constexpr std::uint8_t KRegisterAddressOffset = 0x07;
-    constexpr std::uint8_t KRegisterPeriod = 2;
+    using TRegister = TRegisterMap::TBusVoltage;
 
-    return SetVoltageRegister< KRegisterAddressOffset, KRegisterPeriod >(
-        aShuntLimit, KMaxShuntVoltage, aChannel );
+    std::uint16_t voltageRegister = 0;
+    const auto result = GetVoltageRegister< TRegister >( voltageRegister, aChannel );
+    if ( result == AbstractPlatform::KOk )
+    {
+        const auto& scale = iChannelScale[ aChannel - KChannel1 ];
+        aMicroVolts = Calibrate(
+            BusRegisterToUv( voltageRegister ), scale.iBusVoltageGain, scale.iBusVoltageOffsetUv );
+    }
+    return result;
 }
 
 CIina3221::TErrorCode
-CIina3221::GetShuntWarningAlertLimit( float& aShuntLimit, std::uint8_t aChannel ) NOEXCEPT
+CIina3221::SetShuntResistanceUOhm( std::uint32_t aMicroOhms, std::uint8_t aChannel ) NOEXCEPT
 {
-    constexpr std::uint8_t KRegisterAddressOffset = 0x08;
-    constexpr std::uint8_t KRegisterPeriod = 2;
+    if ( aChannel < KChannel1 || aChannel > KChannelNumber )
+    {
+        return AbstractPlatform::KInvalidArgumentError;
+    }
 
-    return GetVoltageRegister< KRegisterAddressOffset, KRegisterPeriod >(
-        aShuntLimit, KMaxShuntVoltage, aChannel );
+    const auto index = aChannel - KChannel1;
+    iShuntResistanceUOhm[ index ] = aMicroOhms;
+    // I[µA] = V[µV] * 10^6 / R[µΩ]
+    iCurrentScale[ index ]
+        = aMicroOhms != 0 ? ( std::int64_t{ 1000000 } * KCurrentScaleOne ) / aMicroOhms : 0;
+    return AbstractPlatform::KOk;
 }
 
 CIina3221::TErrorCode
-CIina3221::SetShuntWarningAlertLimit( float aShuntLimit, std::uint8_t aChannel ) NOEXCEPT
+CIina3221::SetShuntResistance( float aOhms, std::uint8_t aChannel ) NOEXCEPT
 {
-    constexpr std::uint8_t KRegisterAddressOffset = 0x08;
-    constexpr std::uint8_t KRegisterPeriod = 2;
-
-    return SetVoltageRegister< KRegisterAddressOffset, KRegisterPeriod >(
-        aShuntLimit, KMaxShuntVoltage, aChannel );
+    // Also rejects NaN, the microohm conversion is undefined outside std::uint32_t
+    if ( !( aOhms >= 0.0f && aOhms <= KMaxShuntResistance ) )
+    {
+        return AbstractPlatform::KInvalidArgumentError;
+    }
+    return SetShuntResistanceUOhm( static_cast< std::uint32_t >( aOhms * 1e6f + 0.5f ), aChannel );
 }
 
 CIina3221::TErrorCode
-CIina3221::GetShuntVoltageSum( float& aShuntSum ) NOEXCEPT
+CIina3221::SetChannelCalibration( const CChannelCalibration& aCalibration,
+                                  std::uint8_t aChannel ) NOEXCEPT
 {
-    constexpr std::uint8_t KRegisterAddress = 0x0D;
-    std::uint16_t voltageRegister;
-    const auto result = ReadRegister( KRegisterAddress, voltageRegister );
-    if ( result != AbstractPlatform::KOk )
+    if ( aChannel < KChannel1 || aChannel > KChannelNumber
+         || !IsCalibrationGain( aCalibration.iShuntVoltageGain )
+         || !IsCalibrationGain( aCalibration.iBusVoltageGain )
+         || !IsCalibrationOffset( aCalibration.iShuntVoltageOffset, KMaxShuntVoltageUv )
+         || !IsCalibrationOffset( aCalibration.iBusVoltageOffset, KMaxBusVoltageUv ) )
     {
-        aShuntSum = BusRegisterToVoltage< 2 >( voltageRegister, iMaxShuntVoltage );
+        return AbstractPlatform::KInvalidArgumentError;
     }
-    return result;
+
+    auto& scale = iChannelScale[ aChannel - KChannel1 ];
+    const double gainOne = static_cast< double >( KCurrentScaleOne );
+    scale.iShuntVoltageGain
+        = static_cast< std::int64_t >( aCalibration.iShuntVoltageGain * gainOne + 0.5 );
+    scale.iShuntVoltageOffsetUv
+        = RoundToInt32( aCalibration.iShuntVoltageOffset * KMicroVoltsPerVolt );
+    scale.iBusVoltageGain
+        = static_cast< std::int64_t >( aCalibration.iBusVoltageGain * gainOne + 0.5 );
+    scale.iBusVoltageOffsetUv = RoundToInt32( aCalibration.iBusVoltageOffset * KMicroVoltsPerVolt );
+    return AbstractPlatform::KOk;
 }
 
 CIina3221::TErrorCode
-CIina3221::GetShuntVoltageSumLimit( float& aShuntSumLimit ) NOEXCEPT
+CIina3221::CurrentA( float& aCurrent, std::uint8_t aChannel ) NOEXCEPT
 {
-    constexpr std::uint8_t KRegisterAddress = 0x0E;
-    std::uint16_t voltageRegister = 0;
-    const auto result = ReadRegister( KRegisterAddress, voltageRegister );
+    CChannelPower channelPower;
+    const auto result = ReadChannelPower( channelPower, aChannel );
     if ( result == AbstractPlatform::KOk )
     {
-        aShuntSumLimit = BusRegisterToVoltage< 2 >( voltageRegister, KMaxShuntVoltage );
+        aCurrent = channelPower.iCurrent;
     }
     return result;
 }
 
 CIina3221::TErrorCode
-CIina3221::SetShuntVoltageSumLimit( float aShuntSumLimit ) NOEXCEPT
+CIina3221::PowerW( float& aPower, std::uint8_t aChannel ) NOEXCEPT
 {
-    constexpr std::uint8_t KRegisterAddress = 0x0E;
-    const std::uint16_t voltageRegister
-        = VoltageToBusRegister< 2 >( aShuntSumLimit, KMaxShuntVoltage );
-    return WriteRegister( KRegisterAddress, voltageRegister );
+    CChannelPower channelPower;
+    const auto result = ReadChannelPower( channelPower, aChannel );
+    if ( result == AbstractPlatform::KOk )
+    {
+        aPower = channelPower.iPower;
+    }
+    return result;
 }
 
 CIina3221::TErrorCode
-CIina3221::GetMaskEnable( CMaskEnable& aMaskEnable ) NOEXCEPT
+CIina3221::ReadChannelPower( CChannelPower& aChannelPower, std::uint8_t aChannel ) NOEXCEPT
 {
-    constexpr std::uint8_t KRegisterAddress = 0x0F;
-    std::uint16_t maskEnableRegister = 0x0000;
-    const auto result = ReadRegister( KRegisterAddress, maskEnableRegister );
-    if ( result == AbstractPlatform::KOk )
+    if ( aChannel < KChannel1 || aChannel > KChannelNumber
+         || iShuntResistanceUOhm[ aChannel - KChannel1 ] == 0 )
     {
-        UnpackMaskEnable( aMaskEnable, maskEnableRegister );
+        return AbstractPlatform::KInvalidArgumentError;
     }
-    return result;
+
+    // Shunt and bus registers of a channel are adjacent
+    const auto shuntRegisterAddress = TRegisterMap::TShuntVoltage::Address( aChannel );
+    std::uint16_t registers[ 2 ] = { };
+    if ( iSnapshotReadMode == SnapshotReadMode::Block )
+    {
+        const auto result = ReadRegisterBlock( shuntRegisterAddress, registers, 2 );
+        if ( result != AbstractPlatform::KOk )
+        {
+            return result;
+        }
+    }
+    else
+    {
+        for ( std::uint8_t i = 0; i < 2; ++i )
+        {
+            const auto result = ReadRegister( shuntRegisterAddress + i, registers[ i ] );
+            if ( result != AbstractPlatform::KOk )
+            {
+                return result;
+            }
+        }
+    }
+
+    // Same calibrated microvolt path as ShuntVoltageUv, BusVoltageUv and CurrentUa
+    const auto& scale = iChannelScale[ aChannel - KChannel1 ];
+    const auto shuntMicroVolts = Calibrate(
+        ShuntRegisterToUv( registers[ 0 ] ), scale.iShuntVoltageGain, scale.iShuntVoltageOffsetUv );
+    const auto busMicroVolts = Calibrate(
+        BusRegisterToUv( registers[ 1 ] ), scale.iBusVoltageGain, scale.iBusVoltageOffsetUv );
+
+    aChannelPower.iShuntVoltage = static_cast< float >( shuntMicroVolts ) * KVoltsPerMicroVolt;
+    aChannelPower.iBusVoltage = static_cast< float >( busMicroVolts ) * KVoltsPerMicroVolt;
+    // µA to A with the same factor as µV to V
+    aChannelPower.iCurrent
+        = static_cast< float >( ShuntUvToUa( shuntMicroVolts, aChannel ) ) * KVoltsPerMicroVolt;
+    aChannelPower.iPower = aChannelPower.iBusVoltage * aChannelPower.iCurrent;
+    return AbstractPlatform::KOk;
 }
 
-CIina3221::TErrorCode
-CIina3221::SetMaskEnable( const CMaskEnable& aMaskEnable ) NOEXCEPT
+std::int32_t
+CIina3221::Calibrate( std::int32_t aMicroVolts,
+                      std::int64_t aGain,
+                      std::int32_t aOffsetUv ) NOEXCEPT
 {
-    constexpr std::uint8_t KRegisterAddress = 0x0F;
-    const std::uint16_t maskEnableRegister = PackMaskEnable( aMaskEnable );
-    return WriteRegister( KRegisterAddress, maskEnableRegister );
+    return static_cast< std::int32_t >( aMicroVolts * aGain / KCurrentScaleOne ) + aOffsetUv;
 }
 
 CIina3221::TErrorCode
-CIina3221::GetPowerValidUpperLimit( float& aPowerValidUpperLimit ) NOEXCEPT
+CIina3221::CurrentUa( std::int32_t& aMicroAmps, std::uint8_t aChannel ) NOEXCEPT
 {
-    constexpr std::uint8_t KRegisterAddress = 0x10;
-    std::uint16_t voltageRegister = 0;
-    const auto result = ReadRegister( KRegisterAddress, voltageRegister );
+    if ( aChannel < KChannel1 || aChannel > KChannelNumber
+         || iShuntResistanceUOhm[ aChannel - KChannel1 ] == 0 )
+    {
+        return AbstractPlatform::KInvalidArgumentError;
+    }
+
+    std::int32_t shuntMicroVolts = 0;
+    const auto result = ShuntVoltageUv( shuntMicroVolts, aChannel );
     if ( result == AbstractPlatform::KOk )
     {
-        aPowerValidUpperLimit
-            = BusRegisterToVoltage( voltageRegister, KMaxBusVoltage, KFullScaleRegisterValue );
+        aMicroAmps = ShuntUvToUa( shuntMicroVolts, aChannel );
     }
     return result;
 }
 
-CIina3221::TErrorCode
-CIina3221::SetPowerValidUpperLimit( float aPowerValidUpperLimit ) NOEXCEPT
+std::int16_t
+CIina3221::VoltageRegisterToCounts( std::uint16_t aVoltageRegister ) NOEXCEPT
 {
-    constexpr std::uint8_t KRegisterAddress = 0x10;
-    const std::uint16_t voltageRegister
-        = VoltageToBusRegister( aPowerValidUpperLimit, KMaxBusVoltage, KFullScaleRegisterValue );
-    return WriteRegister( KRegisterAddress, voltageRegister );
+    return RegisterToCounts( aVoltageRegister );
 }
 
-CIina3221::TErrorCode
-CIina3221::GetPowerValidLowerLimit( float& aPowerValidLowerLimit ) NOEXCEPT
+std::int32_t
+CIina3221::ShuntRegisterToUv( std::uint16_t aShuntVoltageRegister ) NOEXCEPT
 {
-    constexpr std::uint8_t KRegisterAddress = 0x11;
-    std::uint16_t voltageRegister = 0;
-    const auto result = ReadRegister( KRegisterAddress, voltageRegister );
-    if ( result == AbstractPlatform::KOk )
-    {
-        aPowerValidLowerLimit
-            = BusRegisterToVoltage( voltageRegister, KMaxBusVoltage, KFullScaleRegisterValue );
-    }
-    return result;
+    return RegisterToMicroVolts< 3, KMaxShuntVoltageUv >( aShuntVoltageRegister );
 }
 
-CIina3221::TErrorCode
-CIina3221::SetPowerValidLowerLimit( float aPowerValidLowerLimit ) NOEXCEPT
+std::int32_t
+CIina3221::BusRegisterToUv( std::uint16_t aBusVoltageRegister ) NOEXCEPT
 {
-    constexpr std::uint8_t KRegisterAddress = 0x11;
-    const std::uint16_t voltageRegister
-        = VoltageToBusRegister( aPowerValidLowerLimit, KMaxBusVoltage, KFullScaleRegisterValue );
-    return WriteRegister( KRegisterAddress, voltageRegister );
+    return RegisterToMicroVolts< 3, KMaxBusVoltageUv >( aBusVoltageRegister );
 }
 
-/************************ Private part ************************/
-template < std::uint8_t taMultiRegisterOffset, std::uint8_t taMultiRegisterPeriod >
-CIina3221::TErrorCode
-CIina3221::GetVoltageRegister( std::uint16_t& aVoltageRegister, std::uint8_t aChannel ) NOEXCEPT
+float
+CIina3221::ShuntRegisterToVolts( std::uint16_t aShuntVoltageRegister ) NOEXCEPT
+{
+    return RegisterToVolts< 3, KMaxShuntVoltageUv >( aShuntVoltageRegister );
+}
+
+float
+CIina3221::BusRegisterToVolts( std::uint16_t aBusVoltageRegister ) NOEXCEPT
+{
+    return RegisterToVolts< 3, KMaxBusVoltageUv >( aBusVoltageRegister );
+}
+
+std::int32_t
+CIina3221::ShuntUvToUa( std::int32_t aMicroVolts, std::uint8_t aChannel ) const NOEXCEPT
 {
-    if ( aChannel > KChannelNumber )
+    if ( aChannel < KChannel1 || aChannel > KChannelNumber )
     {
-        return AbstractPlatform::KInvalidArgumentError;
+        return 0;
     }
-    return ReadRegister(
-        MultiRegisterAddress( taMultiRegisterOffset, taMultiRegisterPeriod, aChannel ),
-        aVoltageRegister );
+
+    using TLimits = std::numeric_limits< std::int64_t >;
+    const auto scale = iCurrentScale[ aChannel - KChannel1 ];
+
+    // Inputs beyond the 64-bit product range saturate the result as well
+    const std::int64_t maxMicroVolts = scale != 0 ? TLimits::max( ) / scale : TLimits::max( );
+    const std::int64_t microAmps
+        = Clamp( std::int64_t{ aMicroVolts }, -maxMicroVolts, maxMicroVolts ) * scale
+          / KCurrentScaleOne;
+    return static_cast< std::int32_t >(
+        Clamp( microAmps,
+               std::int64_t{ std::numeric_limits< std::int32_t >::min( ) },
+               std::int64_t{ std::numeric_limits< std::int32_t >::max( ) } ) );
 }
 
-template < std::uint8_t taMultiRegisterOffset, std::uint8_t taMultiRegisterPeriod >
 CIina3221::TErrorCode
-CIina3221::SetVoltageRegister( std::uint16_t aVoltageRegister, std::uint8_t aChannel ) NOEXCEPT
+CIina3221::ReadSnapshot( CMeasurementSnapshot& aSnapshot ) NOEXCEPT
 {
-    if ( aChannel > KChannelNumber )
+    std::uint16_t registers[ KMeasurementRegisterNumber ] = { };
+
+    if ( iSnapshotReadMode == SnapshotReadMode::Block )
     {
-        return AbstractPlatform::KInvalidArgumentError;
+        const auto result
+            = ReadRegisterBlock( KRegMeasurementFirst, registers, KMeasurementRegisterNumber );
+        if ( result != AbstractPlatform::KOk )
+        {
+            return result;
+        }
+    }
+    else
+    {
+        for ( std::uint8_t i = 0; i < KMeasurementRegisterNumber; ++i )
+        {
+            const auto result = ReadRegister( KRegMeasurementFirst + i, registers[ i ] );
+            if ( result != AbstractPlatform::KOk )
+            {
+                return result;
+            }
+        }
     }
 
-    return WriteRegister(
-        MultiRegisterAddress( taMultiRegisterOffset, taMultiRegisterPeriod, aChannel ),
-        aVoltageRegister );
+    DecodeSnapshot( registers, aSnapshot );
+    return AbstractPlatform::KOk;
 }
 
-template < std::uint8_t taMultiRegisterOffset,
-           std::uint8_t taMultiRegisterPeriod,
-           std::uint8_t taDataLShift >
-CIina3221::TErrorCode
-CIina3221::GetVoltageRegister( float& aVoltage,
-                               float aMaxAbsoluteVoltage,
-                               std::uint8_t aChannel ) NOEXCEPT
+void
+CIina3221::DecodeSnapshot( const std::uint16_t ( &aRegisters )[ KMeasurementRegisterNumber ],
+                           CMeasurementSnapshot& aSnapshot ) NOEXCEPT
 {
-    std::uint16_t voltageRegister = 0;
-    const auto result = GetVoltageRegister< taMultiRegisterOffset, taMultiRegisterPeriod >(
-        voltageRegister, aChannel );
-
-    if ( result == AbstractPlatform::KOk )
+    // Registers are interleaved per channel: shunt, bus, shunt, bus, ...
+    for ( std::uint8_t channel = 0; channel < KChannelNumber; ++channel )
     {
-        aVoltage = BusRegisterToVoltage< taDataLShift >( voltageRegister, aMaxAbsoluteVoltage );
+        const auto shuntRegister = aRegisters[ channel * 2 ];
+        const auto busRegister = aRegisters[ channel * 2 + 1 ];
+
+        aSnapshot.iShuntVoltageRegister[ channel ] = shuntRegister;
+        aSnapshot.iBusVoltageRegister[ channel ] = busRegister;
+        aSnapshot.iShuntVoltage[ channel ] = ShuntRegisterToVolts( shuntRegister );
+        aSnapshot.iBusVoltage[ channel ] = BusRegisterToVolts( busRegister );
     }
-    return result;
 }
 
-template < std::uint8_t taMultiRegisterOffset,
-           std::uint8_t taMultiRegisterPeriod,
-           std::uint8_t taDataLShift >
 CIina3221::TErrorCode
-CIina3221::SetVoltageRegister( float aVoltage,
-                               float aMaxAbsoluteVoltage,
-                               std::uint8_t aChannel ) NOEXCEPT
+CIina3221::ReadSnapshotIfReady( CMeasurementSnapshot& aSnapshot ) NOEXCEPT
 {
-    const std::uint16_t voltageRegister
-        = VoltageToBusRegister< taDataLShift >( aVoltage, aMaxAbsoluteVoltage );
-    return SetVoltageRegister< taMultiRegisterOffset, taMultiRegisterPeriod >( voltageRegister,
-                                                                               aChannel );
+    bool ready = false;
+    if ( iConversionReadyCallback != nullptr )
+    {
+        ready = iConversionReadyCallback( iConversionReadyContext );
+    }
+    else
+    {
+        std::uint16_t maskEnableRegister = 0x0000;
+        const auto result = ReadShadowedRegister( KRegMaskEnable, maskEnableRegister );
+        if ( result != AbstractPlatform::KOk )
+        {
+            return result;
+        }
+        ready = ( maskEnableRegister & KMaskEnableCVRFBit ) != 0;
+    }
+
+    if ( !ready )
+    {
+        aSnapshot.iFresh = false;
+        return AbstractPlatform::KOk;
+    }
+
+    const auto result = ReadSnapshot( aSnapshot );
+    aSnapshot.iFresh = result == AbstractPlatform::KOk;
+    return result;
+}
+
+CIina3221::TErrorCode
+CIina3221::TriggerAndRead( std::uint8_t aChannelMask, CMeasurementSnapshot& aSnapshot ) NOEXCEPT
+{
+    aChannelMask &= KAllChannels;
+    // Callback polls cost no bus time, only the delay callback bounds how long they wait
+    if ( aChannelMask == 0 || ( iConversionReadyCallback != nullptr && iDelayCallback == nullptr ) )
+    {
+        return AbstractPlatform::KInvalidArgumentError;
+    }
+
+    if ( aChannelMask != iTriggerChannelMask )
+    {
+        auto mode = static_cast< std::uint8_t >( iTriggerConfig.GetOperationMode( ) ) & 0x3;
+        if ( mode == 0 )
+        {
+            mode = static_cast< std::uint8_t >( OperationMode::ShuntAndBusVoltageSingleShot );
+        }
+
+        auto config = iTriggerConfig;
+        config.SetReset( false ).SetOperationMode( static_cast< OperationMode >( mode ) );
+        for ( std::uint8_t channel = KChannel1; channel <= KChannelNumber; ++channel )
+        {
+            config.SetChannelEnable( channel, ( aChannelMask & ChannelMask( channel ) ) != 0 );
+        }
+        iTriggerChannelMask = aChannelMask;
+        iTriggerConfigRegister = config.Value( );
+        iTriggerConversionUs = ConversionPeriodUs( config );
+    }
+
+    // Every config write starts a new single-shot conversion, so bypass the shadow skip
+    auto result = WriteRegister( KRegConfig, iTriggerConfigRegister );
+    if ( result != AbstractPlatform::KOk )
+    {
+        Invalidate( );
+        return result;
+    }
+    if ( iShadowCacheEnabled )
+    {
+        UpdateShadow( KRegConfig, iTriggerConfigRegister );
+    }
+
+    aSnapshot.iFresh = false;
+    result = WaitForTriggeredConversion( );
+    if ( result != AbstractPlatform::KOk )
+    {
+        return result;
+    }
+
+    // Registers of the converted channels only, ch1 shunt .. ch3 bus
+    const CConfig triggerConfig{ iTriggerConfigRegister };
+    const auto mode = static_cast< std::uint8_t >( triggerConfig.GetOperationMode( ) );
+    std::uint8_t registerMask = 0;
+    for ( std::uint8_t channel = 0; channel < KChannelNumber; ++channel )
+    {
+        if ( aChannelMask & ( 1 << channel ) )
+        {
+            registerMask |= ( mode & 0x3 ) << ( channel * 2 );
+        }
+    }
+    std::uint8_t first = 0;
+    while ( ( registerMask & ( 1 << first ) ) == 0 )
+    {
+        ++first;
+    }
+    std::uint8_t last = KMeasurementRegisterNumber - 1;
+    while ( ( registerMask & ( 1 << last ) ) == 0 )
+    {
+        --last;
+    }
+
+    std::uint16_t registers[ KMeasurementRegisterNumber ] = { };
+    if ( iSnapshotReadMode == SnapshotReadMode::Block )
+    {
+        // One transaction over the span, cheaper than a second address phase for a gap
+        result = ReadRegisterBlock(
+            KRegMeasurementFirst + first, registers + first, last - first + 1 );
+    }
+    else
+    {
+        for ( auto i = first; i <= last && result == AbstractPlatform::KOk; ++i )
+        {
+            if ( registerMask & ( 1 << i ) )
+            {
+                result = ReadRegister( KRegMeasurementFirst + i, registers[ i ] );
+            }
+        }
+    }
+    if ( result != AbstractPlatform::KOk )
+    {
+        return result;
+    }
+
+    for ( std::uint8_t i = first; i <= last; ++i )
+    {
+        if ( ( registerMask & ( 1 << i ) ) == 0 )
+        {
+            continue;
+        }
+        const auto channel = i / 2;
+        if ( i % 2 == 0 )
+        {
+            aSnapshot.iShuntVoltageRegister[ channel ] = registers[ i ];
+            aSnapshot.iShuntVoltage[ channel ] = ShuntRegisterToVolts( registers[ i ] );
+        }
+        else
+        {
+            aSnapshot.iBusVoltageRegister[ channel ] = registers[ i ];
+            aSnapshot.iBusVoltage[ channel ] = BusRegisterToVolts( registers[ i ] );
+        }
+    }
+    aSnapshot.iFresh = true;
+    return AbstractPlatform::KOk;
+}
+
+CIina3221::TErrorCode
+CIina3221::WaitForTriggeredConversion( ) NOEXCEPT
+{
+    if ( iDelayCallback != nullptr )
+    {
+        // Conversion times are typical values, leave room for internal oscillator tolerance
+        iDelayCallback( iDelayContext,
+                        iTriggerConversionUs + iTriggerConversionUs / KTriggerMarginDivider );
+    }
+
+    // Readiness is confirmed even after the deadline sleep, the margin is not guaranteed. A CVRF
+    // poll costs at least one short transaction and a callback poll is followed by a
+    // KMinPollTimeUs delay, which bounds the time spent polling.
+    const std::uint32_t maxPolls = 2 * iTriggerConversionUs / KMinPollTimeUs + 2;
+    for ( std::uint32_t poll = 0; poll < maxPolls; ++poll )
+    {
+        bool ready = false;
+        if ( iConversionReadyCallback != nullptr )
+        {
+            ready = iConversionReadyCallback( iConversionReadyContext );
+        }
+        else
+        {
+            std::uint16_t maskEnableRegister = 0x0000;
+            const auto result = ReadRegister( KRegMaskEnable, maskEnableRegister );
+            if ( result != AbstractPlatform::KOk )
+            {
+                return result;
+            }
+            ready = ( maskEnableRegister & KMaskEnableCVRFBit ) != 0;
+        }
+        if ( ready )
+        {
+            return AbstractPlatform::KOk;
+        }
+        if ( iConversionReadyCallback != nullptr )
+        {
+            iDelayCallback( iDelayContext, KMinPollTimeUs );
+        }
+    }
+    return AbstractPlatform::KTimeoutError;
+}
+
+std::uint32_t
+CIina3221::ConversionTimeUs( ConversionTime aConversionTime ) NOEXCEPT
+{
+    constexpr std::uint16_t KConversionTimeUs[] = { 140, 204, 332, 588, 1100, 2116, 4156, 8244 };
+    return KConversionTimeUs[ static_cast< std::uint8_t >( aConversionTime ) & 0x7 ];
+}
+
+std::uint16_t
+CIina3221::AveragingSamples( AveragingMode aAveragingMode ) NOEXCEPT
+{
+    constexpr std::uint16_t KAveragingSamples[] = { 1, 4, 16, 64, 128, 256, 512, 1024 };
+    return KAveragingSamples[ static_cast< std::uint8_t >( aAveragingMode ) & 0x7 ];
+}
+
+std::uint32_t
+CIina3221::ConversionPeriodUs( const CConfig& aConfig ) NOEXCEPT
+{
+    const auto mode = static_cast< std::uint8_t >( aConfig.GetOperationMode( ) );
+    const bool shuntEnabled = ( mode & 0x1 ) != 0;
+    const bool busEnabled = ( mode & 0x2 ) != 0;
+
+    std::uint32_t channelTimeUs = 0;
+    if ( shuntEnabled )
+    {
+        channelTimeUs += ConversionTimeUs( aConfig.GetShuntVoltageConversionTime( ) );
+    }
+    if ( busEnabled )
+    {
+        channelTimeUs += ConversionTimeUs( aConfig.GetBusVoltageConversionTime( ) );
+    }
+
+    std::uint32_t channels = 0;
+    for ( std::uint8_t channel = KChannel1; channel <= KChannelNumber; ++channel )
+    {
+        channels += aConfig.GetChannelEnable( channel ) ? 1 : 0;
+    }
+
+    return channelTimeUs * channels * AveragingSamples( aConfig.GetAveragingMode( ) );
+}
+
+CIina3221::TErrorCode
+CIina3221::GetShuntCriticalAlertLimit( float& aShuntLimit, std::uint8_t aChannel ) NOEXCEPT
+{
+    using TRegister = TRegisterMap::TCriticalAlertLimit;
+
+    return GetVoltageRegister< TRegister, KMaxShuntVoltageUv >( aShuntLimit, aChannel );
+}
+
+CIina3221::TErrorCode
+CIina3221::SetShuntCriticalAlertLimit( float aShuntLimit, std::uint8_t aChannel ) NOEXCEPT
+{
+    using TRegister = TRegisterMap::TCriticalAlertLimit;
+
+    return SetVoltageRegister< TRegister, KMaxShuntVoltageUv >( aShuntLimit, aChannel );
+}
+
+CIina3221::TErrorCode
+CIina3221::GetShuntWarningAlertLimit( float& aShuntLimit, std::uint8_t aChannel ) NOEXCEPT
+{
+    using TRegister = TRegisterMap::TWarningAlertLimit;
+
+    return GetVoltageRegister< TRegister, KMaxShuntVoltageUv >( aShuntLimit, aChannel );
+}
+
+CIina3221::TErrorCode
+CIina3221::SetShuntWarningAlertLimit( float aShuntLimit, std::uint8_t aChannel ) NOEXCEPT
+{
+    using TRegister = TRegisterMap::TWarningAlertLimit;
+
+    return SetVoltageRegister< TRegister, KMaxShuntVoltageUv >( aShuntLimit, aChannel );
+}
+
+CIina3221::TErrorCode
+CIina3221::GetShuntVoltageSum( float& aShuntSum ) NOEXCEPT
+{
+    constexpr std::uint8_t KRegisterAddress = TRegisterMap::TShuntVoltageSum::KAddress;
+    std::uint16_t voltageRegister = 0;
+    const auto result = ReadRegister( KRegisterAddress, voltageRegister );
+    if ( result == AbstractPlatform::KOk )
+    {
+        aShuntSum = RegisterToVolts< KSumDataLShift, KMaxShuntVoltageUv >( voltageRegister );
+    }
+    return result;
+}
+
+CIina3221::TErrorCode
+CIina3221::GetShuntVoltageSumLimit( float& aShuntSumLimit ) NOEXCEPT
+{
+    constexpr std::uint8_t KRegisterAddress = TRegisterMap::TShuntVoltageSumLimit::KAddress;
+    std::uint16_t voltageRegister = 0;
+    const auto result = ReadShadowedRegister( KRegisterAddress, voltageRegister );
+    if ( result == AbstractPlatform::KOk )
+    {
+        aShuntSumLimit = RegisterToVolts< KSumDataLShift, KMaxShuntVoltageUv >( voltageRegister );
+    }
+    return result;
+}
+
+CIina3221::TErrorCode
+CIina3221::SetShuntVoltageSumLimit( float aShuntSumLimit ) NOEXCEPT
+{
+    constexpr std::uint8_t KRegisterAddress = TRegisterMap::TShuntVoltageSumLimit::KAddress;
+    const std::uint16_t voltageRegister
+        = VoltsToRegister< KSumDataLShift, KMaxShuntVoltageUv >( aShuntSumLimit );
+    return WriteShadowedRegister( KRegisterAddress, voltageRegister );
+}
+
+CIina3221::TErrorCode
+CIina3221::GetMaskEnable( CMaskEnable& aMaskEnable ) NOEXCEPT
+{
+    std::uint16_t maskEnableRegister = 0x0000;
+    const auto result = ReadShadowedRegister( KRegMaskEnable, maskEnableRegister );
+    if ( result == AbstractPlatform::KOk )
+    {
+        aMaskEnable = CMaskEnable{ maskEnableRegister };
+    }
+    return result;
+}
+
+CIina3221::TErrorCode
+CIina3221::SetMaskEnable( const CMaskEnable& aMaskEnable ) NOEXCEPT
+{
+    return WriteShadowedRegister( KRegMaskEnable, aMaskEnable.Value( ) );
+}
+
+CIina3221::TErrorCode
+CIina3221::GetPowerValidUpperLimit( float& aPowerValidUpperLimit ) NOEXCEPT
+{
+    constexpr std::uint8_t KRegisterAddress = TRegisterMap::TPowerValidUpperLimit::KAddress;
+    std::uint16_t voltageRegister = 0;
+    const auto result = ReadShadowedRegister( KRegisterAddress, voltageRegister );
+    if ( result == AbstractPlatform::KOk )
+    {
+        aPowerValidUpperLimit = BusRegisterToVolts( voltageRegister );
+    }
+    return result;
+}
+
+CIina3221::TErrorCode
+CIina3221::SetPowerValidUpperLimit( float aPowerValidUpperLimit ) NOEXCEPT
+{
+    constexpr std::uint8_t KRegisterAddress = TRegisterMap::TPowerValidUpperLimit::KAddress;
+    const std::uint16_t voltageRegister
+        = VoltsToRegister< 3, KMaxBusVoltageUv >( aPowerValidUpperLimit );
+    return WriteShadowedRegister( KRegisterAddress, voltageRegister );
+}
+
+CIina3221::TErrorCode
+CIina3221::GetPowerValidLowerLimit( float& aPowerValidLowerLimit ) NOEXCEPT
+{
+    constexpr std::uint8_t KRegisterAddress = TRegisterMap::TPowerValidLowerLimit::KAddress;
+    std::uint16_t voltageRegister = 0;
+    const auto result = ReadShadowedRegister( KRegisterAddress, voltageRegister );
+    if ( result == AbstractPlatform::KOk )
+    {
+        aPowerValidLowerLimit = BusRegisterToVolts( voltageRegister );
+    }
+    return result;
+}
+
+CIina3221::TErrorCode
+CIina3221::SetPowerValidLowerLimit( float aPowerValidLowerLimit ) NOEXCEPT
+{
+    constexpr std::uint8_t KRegisterAddress = TRegisterMap::TPowerValidLowerLimit::KAddress;
+    const std::uint16_t voltageRegister
+        = VoltsToRegister< 3, KMaxBusVoltageUv >( aPowerValidLowerLimit );
+    return WriteShadowedRegister( KRegisterAddress, voltageRegister );
+}
+
+/************************ Transaction ************************/
+CIina3221::CTransaction&
+CIina3221::CTransaction::Stage( std::uint8_t aRegisterAddress,
+                                std::uint16_t aRegisterValue ) NOEXCEPT
+{
+    const auto slot = ShadowSlot( aRegisterAddress );
+    iValues[ slot ] = aRegisterValue;
+    iStagedMask |= 1 << slot;
+    return *this;
+}
+
+CIina3221::CTransaction&
+CIina3221::CTransaction::RejectChannel( std::uint8_t aRegisterAddress ) NOEXCEPT
+{
+    if ( iStagingError == AbstractPlatform::KOk )
+    {
+        iStagingError = AbstractPlatform::KInvalidArgumentError;
+        iFailedRegister = aRegisterAddress;
+    }
+    return *this;
+}
+
+CIina3221::CTransaction&
+CIina3221::CTransaction::Reset( ) NOEXCEPT
+{
+    iReset = true;
+    return *this;
+}
+
+CIina3221::CTransaction&
+CIina3221::CTransaction::SetConfig( const CConfig& aConfig ) NOEXCEPT
+{
+    if ( aConfig.GetReset( ) )
+    {
+        Reset( );
+    }
+    return Stage( KRegConfig, CConfig{ aConfig }.SetReset( false ).Value( ) );
+}
+
+CIina3221::CTransaction&
+CIina3221::CTransaction::SetMaskEnable( const CMaskEnable& aMaskEnable ) NOEXCEPT
+{
+    return Stage( KRegMaskEnable, aMaskEnable.Value( ) );
+}
+
+CIina3221::CTransaction&
+CIina3221::CTransaction::SetShuntCriticalAlertLimit( float aShuntLimit,
+                                                     std::uint8_t aChannel ) NOEXCEPT
+{
+    using TRegister = TRegisterMap::TCriticalAlertLimit;
+    if ( aChannel < KChannel1 || aChannel > KChannelNumber )
+    {
+        return RejectChannel( TRegister::KAddress );
+    }
+    return Stage( TRegister::Address( aChannel ),
+                  VoltsToRegister< 3, KMaxShuntVoltageUv >( aShuntLimit ) );
+}
+
+CIina3221::CTransaction&
+CIina3221::CTransaction::SetShuntWarningAlertLimit( float aShuntLimit,
+                                                    std::uint8_t aChannel ) NOEXCEPT
+{
+    using TRegister = TRegisterMap::TWarningAlertLimit;
+    if ( aChannel < KChannel1 || aChannel > KChannelNumber )
+    {
+        return RejectChannel( TRegister::KAddress );
+    }
+    return Stage( TRegister::Address( aChannel ),
+                  VoltsToRegister< 3, KMaxShuntVoltageUv >( aShuntLimit ) );
+}
+
+CIina3221::CTransaction&
+CIina3221::CTransaction::SetShuntVoltageSumLimit( float aShuntSumLimit ) NOEXCEPT
+{
+    return Stage( TRegisterMap::TShuntVoltageSumLimit::KAddress,
+                  VoltsToRegister< KSumDataLShift, KMaxShuntVoltageUv >( aShuntSumLimit ) );
+}
+
+CIina3221::CTransaction&
+CIina3221::CTransaction::SetPowerValidUpperLimit( float aPowerValidUpperLimit ) NOEXCEPT
+{
+    return Stage( TRegisterMap::TPowerValidUpperLimit::KAddress,
+                  VoltsToRegister< 3, KMaxBusVoltageUv >( aPowerValidUpperLimit ) );
+}
+
+CIina3221::CTransaction&
+CIina3221::CTransaction::SetPowerValidLowerLimit( float aPowerValidLowerLimit ) NOEXCEPT
+{
+    return Stage( TRegisterMap::TPowerValidLowerLimit::KAddress,
+                  VoltsToRegister< 3, KMaxBusVoltageUv >( aPowerValidLowerLimit ) );
+}
+
+CIina3221::TErrorCode
+CIina3221::CTransaction::Commit( ) NOEXCEPT
+{
+    if ( iStagingError != AbstractPlatform::KOk )
+    {
+        return iStagingError;
+    }
+    iFailedRegister = KNoRegister;
+
+    if ( iReset )
+    {
+        const auto result = iDevice.WriteShadowedRegister(
+            KRegConfig, CConfig{ }.SetReset( true ).Value( ) );
+        if ( result != AbstractPlatform::KOk )
+        {
+            iFailedRegister = KRegConfig;
+            return result;
+        }
+        // The reset is done, a retry must not repeat it
+        iReset = false;
+    }
+
+    // Limits first, then the alert controls that act on them, then the operating mode
+    static constexpr std::uint8_t KCommitOrder[] = {
+        TRegisterMap::TCriticalAlertLimit::Address( 1 ),
+        TRegisterMap::TCriticalAlertLimit::Address( 2 ),
+        TRegisterMap::TCriticalAlertLimit::Address( 3 ),
+        TRegisterMap::TWarningAlertLimit::Address( 1 ),
+        TRegisterMap::TWarningAlertLimit::Address( 2 ),
+        TRegisterMap::TWarningAlertLimit::Address( 3 ),
+        TRegisterMap::TShuntVoltageSumLimit::KAddress,
+        TRegisterMap::TPowerValidUpperLimit::KAddress,
+        TRegisterMap::TPowerValidLowerLimit::KAddress,
+        KRegMaskEnable,
+        KRegConfig,
+    };
+    static_assert( sizeof( KCommitOrder ) == KShadowRegisterNumber, "" );
+
+    for ( const auto registerAddress : KCommitOrder )
+    {
+        const auto slot = ShadowSlot( registerAddress );
+        if ( ( iStagedMask & ( 1 << slot ) ) == 0 )
+        {
+            continue;
+        }
+
+        const auto result = iDevice.WriteShadowedRegister( registerAddress, iValues[ slot ] );
+        if ( result != AbstractPlatform::KOk )
+        {
+            iFailedRegister = registerAddress;
+            return result;
+        }
+        iStagedMask &= ~( 1 << slot );
+    }
+
+    return AbstractPlatform::KOk;
+}
+
+void
+CIina3221::CTransaction::Clear( ) NOEXCEPT
+{
+    iStagedMask = 0;
+    iReset = false;
+    iStagingError = AbstractPlatform::KOk;
+    iFailedRegister = KNoRegister;
+}
+
+/************************ Read plan ************************/
+CIina3221::CReadPlan&
+CIina3221::CReadPlan::Reject( std::uint8_t aRegisterAddress ) NOEXCEPT
+{
+    if ( iStagingError == AbstractPlatform::KOk )
+    {
+        iStagingError = AbstractPlatform::KInvalidArgumentError;
+        iFailedRegister = aRegisterAddress;
+    }
+    return *this;
+}
+
+CIina3221::CReadPlan&
+CIina3221::CReadPlan::AddRegister( std::uint8_t aRegisterAddress ) NOEXCEPT
+{
+    if ( aRegisterAddress >= KRegisterNumber )
+    {
+        return Reject( aRegisterAddress );
+    }
+    iRequestedMask |= std::uint32_t{ 1 } << aRegisterAddress;
+    iPlanned = false;
+    return *this;
+}
+
+CIina3221::CReadPlan&
+CIina3221::CReadPlan::AddShuntVoltage( std::uint8_t aChannel ) NOEXCEPT
+{
+    using TRegister = TRegisterMap::TShuntVoltage;
+    if ( aChannel < KChannel1 || aChannel > KChannelNumber )
+    {
+        return Reject( TRegister::KAddress );
+    }
+    return AddRegister( TRegister::Address( aChannel ) );
+}
+
+CIina3221::CReadPlan&
+CIina3221::CReadPlan::AddBusVoltage( std::uint8_t aChannel ) NOEXCEPT
+{
+    using TRegister = TRegisterMap::TBusVoltage;
+    if ( aChannel < KChannel1 || aChannel > KChannelNumber )
+    {
+        return Reject( TRegister::KAddress );
+    }
+    return AddRegister( TRegister::Address( aChannel ) );
+}
+
+CIina3221::CReadPlan&
+CIina3221::CReadPlan::AddShuntVoltageSum( ) NOEXCEPT
+{
+    return AddRegister( TRegisterMap::TShuntVoltageSum::KAddress );
+}
+
+CIina3221::CReadPlan&
+CIina3221::CReadPlan::AddMaskEnable( ) NOEXCEPT
+{
+    return AddRegister( KRegMaskEnable );
+}
+
+std::uint8_t
+CIina3221::CReadPlan::Plan( ) NOEXCEPT
+{
+    // Reading one register costs 2 data bytes, a separate span costs a pointer write and another
+    // address phase: one register of gap is cheaper to read through, two are not
+    constexpr std::uint8_t KMaxBridgedRegisters = 1;
+    // Reading mask/enable clears the conversion-ready flag and latched alert flags
+    constexpr std::uint32_t KReadSideEffectMask = std::uint32_t{ 1 } << KRegMaskEnable;
+
+    const bool blockReads = iDevice.iSnapshotReadMode == SnapshotReadMode::Block;
+    iSpanNumber = 0;
+    for ( std::uint8_t address = 0; address < KRegisterNumber; ++address )
+    {
+        if ( ( iRequestedMask & ( std::uint32_t{ 1 } << address ) ) == 0 )
+        {
+            continue;
+        }
+
+        if ( blockReads && iSpanNumber != 0 )
+        {
+            auto& span = iSpans[ iSpanNumber - 1 ];
+            const std::uint8_t gapFirst = span.iFirst + span.iCount;
+            const auto gapMask = ( std::uint32_t{ 1 } << address )
+                                 - ( std::uint32_t{ 1 } << gapFirst );
+            if ( address - gapFirst <= KMaxBridgedRegisters
+                 && ( gapMask & KReadSideEffectMask ) == 0 )
+            {
+                span.iCount = address - span.iFirst + 1;
+                continue;
+            }
+        }
+        iSpans[ iSpanNumber++ ] = CSpan{ address, 1 };
+    }
+
+    iPlannedReadMode = iDevice.iSnapshotReadMode;
+    iPlanned = true;
+    return iSpanNumber;
+}
+
+CIina3221::TErrorCode
+CIina3221::CReadPlan::Execute( ) NOEXCEPT
+{
+    if ( iStagingError != AbstractPlatform::KOk )
+    {
+        return iStagingError;
+    }
+    iFailedRegister = KNoRegister;
+
+    if ( !iPlanned || iPlannedReadMode != iDevice.iSnapshotReadMode )
+    {
+        Plan( );
+    }
+
+    // Start where the register pointer already is, whatever the previous access was
+    std::uint8_t start = 0;
+    for ( std::uint8_t index = 0; index < iSpanNumber; ++index )
+    {
+        if ( iSpans[ index ].iFirst == iDevice.iLastRegisterAddress )
+        {
+            start = index;
+            break;
+        }
+    }
+
+    for ( std::uint8_t step = 0; step < iSpanNumber; ++step )
+    {
+        const auto& span = iSpans[ ( start + step ) % iSpanNumber ];
+        const auto result
+            = iDevice.ReadRegisterBlock( span.iFirst, iValues + span.iFirst, span.iCount );
+        if ( result != AbstractPlatform::KOk )
+        {
+            iFailedRegister = span.iFirst;
+            return result;
+        }
+    }
+    return AbstractPlatform::KOk;
+}
+
+void
+CIina3221::CReadPlan::Clear( ) NOEXCEPT
+{
+    iRequestedMask = 0;
+    iPlanned = false;
+    iSpanNumber = 0;
+    iStagingError = AbstractPlatform::KOk;
+    iFailedRegister = KNoRegister;
+}
+
+std::int32_t
+CIina3221::CReadPlan::ShuntVoltageUv( std::uint8_t aChannel ) const NOEXCEPT
+{
+    if ( aChannel < KChannel1 || aChannel > KChannelNumber )
+    {
+        return 0;
+    }
+    return ShuntRegisterToUv( Value( TRegisterMap::TShuntVoltage::Address( aChannel ) ) );
+}
+
+std::int32_t
+CIina3221::CReadPlan::BusVoltageUv( std::uint8_t aChannel ) const NOEXCEPT
+{
+    if ( aChannel < KChannel1 || aChannel > KChannelNumber )
+    {
+        return 0;
+    }
+    return BusRegisterToUv( Value( TRegisterMap::TBusVoltage::Address( aChannel ) ) );
+}
+
+/************************ Private part ************************/
+template < typename taRegister >
+CIina3221::TErrorCode
+CIina3221::GetVoltageRegister( std::uint16_t& aVoltageRegister, std::uint8_t aChannel ) NOEXCEPT
+{
+    if ( aChannel < KChannel1 || aChannel > KChannelNumber )
+    {
+        return AbstractPlatform::KInvalidArgumentError;
+    }
+    return ReadShadowedRegister( taRegister::Address( aChannel ), aVoltageRegister );
+}
+
+template < typename taRegister >
+CIina3221::TErrorCode
+CIina3221::SetVoltageRegister( std::uint16_t aVoltageRegister, std::uint8_t aChannel ) NOEXCEPT
+{
+    if ( aChannel < KChannel1 || aChannel > KChannelNumber )
+    {
+        return AbstractPlatform::KInvalidArgumentError;
+    }
+
+    return WriteShadowedRegister( taRegister::Address( aChannel ), aVoltageRegister );
+}
+
+template < typename taRegister, std::int32_t taFullScaleMicroVolts >
+CIina3221::TErrorCode
+CIina3221::GetVoltageRegister( float& aVoltage, std::uint8_t aChannel ) NOEXCEPT
+{
+    std::uint16_t voltageRegister = 0;
+    const auto result = GetVoltageRegister< taRegister >( voltageRegister, aChannel );
+
+    if ( result == AbstractPlatform::KOk )
+    {
+        aVoltage = RegisterToVolts< 3, taFullScaleMicroVolts >( voltageRegister );
+    }
+    return result;
+}
+
+template < typename taRegister, std::int32_t taFullScaleMicroVolts >
+CIina3221::TErrorCode
+CIina3221::SetVoltageRegister( float aVoltage, std::uint8_t aChannel ) NOEXCEPT
+{
+    return SetVoltageRegister< taRegister >(
+        VoltsToRegister< 3, taFullScaleMicroVolts >( aVoltage ), aChannel );
 }
 
 }  // namespace ExternalHardware
\ No newline at end of file
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <AbstractPlatform/common/Platform.hpp>
 #include <AbstractPlatform/common/ErrorCode.hpp>
 #include <AbstractPlatform/common/PlatformLiteral.hpp>
 #include <AbstractPlatform/i2c/AbstractI2C.hpp>
+#include <ExternalHardware/ina3221/INA3221Registers.hpp>
+#ifdef INA3221_INSTRUMENTATION
+#include <ExternalHardware/ina3221/INA3221Instrumentation.hpp>
+#endif
 
 namespace ExternalHardware
 {
@@ -17,8 +22,15 @@ public:
     static constexpr float KMaxBusVoltage = 32.76f;     // 0x0FFF = 32.76V
     static constexpr float KMaxShuntVoltage = 0.1638f;  // 0x0FFF = 0.1638V
 
-    float iMaxBusVoltage = KMaxBusVoltage;
-    float iMaxShuntVoltage = KMaxShuntVoltage;
+    static constexpr std::int32_t KMaxBusVoltageUv = 32760000;  // 0x0FFF = 32.76V
+    static constexpr std::int32_t KMaxShuntVoltageUv = 163800;  // 0x0FFF = 0.1638V
+
+    static constexpr std::int16_t KFullScaleCounts = 0x0FFF;
+    static constexpr std::int32_t KShuntVoltageLsbUv = KMaxShuntVoltageUv / KFullScaleCounts;
+    static constexpr std::int32_t KBusVoltageLsbUv = KMaxBusVoltageUv / KFullScaleCounts;
+
+    // Float results are the microvolt results times this factor
+    static constexpr float KVoltsPerMicroVolt = 1e-6f;
 
     static constexpr std::uint8_t KDefaultAddress = 0x40;  // A0 pulled to GND
     static constexpr std::uint8_t KVSAddress = 0x41;       // A0 pulled to VS
@@ -28,6 +40,16 @@ public:
     static constexpr std::uint8_t KChannel1 = 0x01;
     static constexpr std::uint8_t KChannel2 = 0x02;
     static constexpr std::uint8_t KChannel3 = 0x03;
+    static constexpr std::uint8_t KChannelNumber = 3;
+
+    // Shunt/bus voltage registers of all channels: ch1 shunt, ch1 bus, ch2 shunt, ...
+    static constexpr std::uint8_t KMeasurementRegisterNumber = 2 * KChannelNumber;
+
+    static constexpr bool
+    IsChannel( std::uint8_t aChannel ) NOEXCEPT
+    {
+        return aChannel >= KChannel1 && aChannel <= KChannelNumber;
+    }
 
     enum class OperationMode : std::uint8_t
     {
@@ -65,72 +87,318 @@ public:
         avg1024 = 0x7,  // Average 1024 samples
     };
 
-    struct CConfig
+    class CConfig : public Ina3221::CRegisterValue< CConfig >
     {
-        CConfig( ){ };
-        OperationMode iOperationMode = OperationMode::ShuntAndBusVoltageContinuous;
-        ConversionTime iShuntVoltageConversionTime = ConversionTime::t1100us;
-        ConversionTime iBusVoltageConversionTime = ConversionTime::t1100us;
-        AveragingMode iAveragingMode = AveragingMode::avg1;
+    public:
+        using TOperationMode = Ina3221::CRegisterField< 0, 3, OperationMode >;
+        using TShuntVoltageConversionTime = Ina3221::CRegisterField< 3, 3, ConversionTime >;
+        using TBusVoltageConversionTime = Ina3221::CRegisterField< 6, 3, ConversionTime >;
+        using TAveragingMode = Ina3221::CRegisterField< 9, 3, AveragingMode >;
+        using TChannel3Enable = Ina3221::CRegisterField< 12, 1, bool >;
+        using TChannel2Enable = Ina3221::CRegisterField< 13, 1, bool >;
+        using TChannel1Enable = Ina3221::CRegisterField< 14, 1, bool >;
+        using TReset = Ina3221::CRegisterField< 15, 1, bool >;
+
+        // Continuous shunt and bus, 1100µs conversions, no averaging, all channels enabled
+        static constexpr std::uint16_t KDefault = Ina3221::CRegisterMap::TConfig::KResetValue;
+
+        constexpr CConfig( ) NOEXCEPT
+            : CRegisterValue{ KDefault }
+        {
+        }
+
+        explicit constexpr CConfig( std::uint16_t aValue ) NOEXCEPT
+            : CRegisterValue{ aValue }
+        {
+        }
+
+        constexpr OperationMode
+        GetOperationMode( ) const NOEXCEPT
+        {
+            return Get< TOperationMode >( );
+        }
+
+        constexpr CConfig&
+        SetOperationMode( OperationMode aOperationMode ) NOEXCEPT
+        {
+            return Set< TOperationMode >( aOperationMode );
+        }
+
+        constexpr ConversionTime
+        GetShuntVoltageConversionTime( ) const NOEXCEPT
+        {
+            return Get< TShuntVoltageConversionTime >( );
+        }
+
+        constexpr CConfig&
+        SetShuntVoltageConversionTime( ConversionTime aConversionTime ) NOEXCEPT
+        {
+            return Set< TShuntVoltageConversionTime >( aConversionTime );
+        }
+
+        constexpr ConversionTime
+        GetBusVoltageConversionTime( ) const NOEXCEPT
+        {
+            return Get< TBusVoltageConversionTime >( );
+        }
+
+        constexpr CConfig&
+        SetBusVoltageConversionTime( ConversionTime aConversionTime ) NOEXCEPT
+        {
+            return Set< TBusVoltageConversionTime >( aConversionTime );
+        }
+
+        constexpr AveragingMode
+        GetAveragingMode( ) const NOEXCEPT
+        {
+            return Get< TAveragingMode >( );
+        }
+
+        constexpr CConfig&
+        SetAveragingMode( AveragingMode aAveragingMode ) NOEXCEPT
+        {
+            return Set< TAveragingMode >( aAveragingMode );
+        }
+
+        // aChannel is KChannel1..KChannel3; channel 1 enable is the most significant bit
+        constexpr bool
+        GetChannelEnable( std::uint8_t aChannel ) const NOEXCEPT
+        {
+            return ( iValue & ChannelEnableMask( aChannel ) ) != 0;
+        }
 
-        bool iChannel3Enable = true;
-        bool iChannel2Enable = true;
-        bool iChannel1Enable = true;
+        constexpr CConfig&
+        SetChannelEnable( std::uint8_t aChannel, bool aEnable ) NOEXCEPT
+        {
+            iValue = aEnable ? iValue | ChannelEnableMask( aChannel )
+                             : iValue & ~ChannelEnableMask( aChannel );
+            return *this;
+        }
+
+        constexpr bool
+        GetReset( ) const NOEXCEPT
+        {
+            return Get< TReset >( );
+        }
+
+        constexpr CConfig&
+        SetReset( bool aReset ) NOEXCEPT
+        {
+            return Set< TReset >( aReset );
+        }
 
-        bool iRstart = false;
+    private:
+        static constexpr std::uint16_t
+        ChannelEnableMask( std::uint8_t aChannel ) NOEXCEPT
+        {
+            return ChannelBit( TChannel1Enable::KMask, aChannel );
+        }
     };
 
-    struct CMaskEnable
+    class CMaskEnable : public Ina3221::CRegisterValue< CMaskEnable >
     {
-        CMaskEnable( ){ };
+    public:
+        using TCVRF = Ina3221::CRegisterField< 0, 1, bool >;  // Conversion ready
+        using TTCF = Ina3221::CRegisterField< 1, 1, bool >;   // Timing control
+        using TPVF = Ina3221::CRegisterField< 2, 1, bool >;   // Power valid
+        using TWF3 = Ina3221::CRegisterField< 3, 1, bool >;   // Warning alert flags
+        using TWF2 = Ina3221::CRegisterField< 4, 1, bool >;
+        using TWF1 = Ina3221::CRegisterField< 5, 1, bool >;
+        using TSF = Ina3221::CRegisterField< 6, 1, bool >;   // Summation alert flag
+        using TCF3 = Ina3221::CRegisterField< 7, 1, bool >;  // Critical alert flags
+        using TCF2 = Ina3221::CRegisterField< 8, 1, bool >;
+        using TCF1 = Ina3221::CRegisterField< 9, 1, bool >;
+        using TCEN = Ina3221::CRegisterField< 10, 1, bool >;  // Critical alert latch enable
+        using TWEN = Ina3221::CRegisterField< 11, 1, bool >;  // Warning alert latch enable
+        using TSSC3 = Ina3221::CRegisterField< 12, 1, bool >;  // Summation channel control
+        using TSSC2 = Ina3221::CRegisterField< 13, 1, bool >;
+        using TSSC1 = Ina3221::CRegisterField< 14, 1, bool >;
+
+        // Read-only status flags, updated by the device
+        static constexpr std::uint16_t KFlagsMask = 0x03FF;
+        // Control bits, written only by the host
+        static constexpr std::uint16_t KControlMask = 0x7C00;
+
+        static constexpr std::uint16_t KDefault = Ina3221::CRegisterMap::TMaskEnable::KResetValue;
+
+        constexpr CMaskEnable( ) NOEXCEPT
+            : CRegisterValue{ KDefault }
+        {
+        }
 
-        bool iCVRF = false;  // Bit 0
-        bool iTCF = true;    // Bit 1
-        bool iPVF = false;   // Bit 2
+        explicit constexpr CMaskEnable( std::uint16_t aValue ) NOEXCEPT
+            : CRegisterValue{ aValue }
+        {
+        }
 
-        bool iWF3 = false;  // Bit 3
-        bool iWF2 = false;  // Bit 4
-        bool iWF1 = false;  // Bit 5
+        constexpr bool
+        GetConversionReady( ) const NOEXCEPT
+        {
+            return Get< TCVRF >( );
+        }
 
-        bool iSF = false;  // Bit 6
+        constexpr bool
+        GetTimingControl( ) const NOEXCEPT
+        {
+            return Get< TTCF >( );
+        }
 
-        bool iCF3 = false;  // Bit 7
-        bool iCF2 = false;  // Bit 8
-        bool iCF1 = false;  // Bit 9
-        bool iCEN = false;  // Bit 10
-        bool iWEN = false;  // Bit 11
+        constexpr bool
+        GetPowerValid( ) const NOEXCEPT
+        {
+            return Get< TPVF >( );
+        }
+
+        constexpr bool
+        GetSummationAlert( ) const NOEXCEPT
+        {
+            return Get< TSF >( );
+        }
 
-        bool iSSC3 = false;  // Bit 12
-        bool iSSC2 = false;  // Bit 13
-        bool iSSC1 = false;  // Bit 14
+        // Per-channel flags, aChannel is KChannel1..KChannel3
+        constexpr bool
+        GetWarningAlert( std::uint8_t aChannel ) const NOEXCEPT
+        {
+            return ( iValue & ChannelBit( TWF1::KMask, aChannel ) ) != 0;
+        }
+
+        constexpr bool
+        GetCriticalAlert( std::uint8_t aChannel ) const NOEXCEPT
+        {
+            return ( iValue & ChannelBit( TCF1::KMask, aChannel ) ) != 0;
+        }
+
+        constexpr bool
+        GetCriticalLatchEnable( ) const NOEXCEPT
+        {
+            return Get< TCEN >( );
+        }
+
+        constexpr CMaskEnable&
+        SetCriticalLatchEnable( bool aEnable ) NOEXCEPT
+        {
+            return Set< TCEN >( aEnable );
+        }
+
+        constexpr bool
+        GetWarningLatchEnable( ) const NOEXCEPT
+        {
+            return Get< TWEN >( );
+        }
+
+        constexpr CMaskEnable&
+        SetWarningLatchEnable( bool aEnable ) NOEXCEPT
+        {
+            return Set< TWEN >( aEnable );
+        }
+
+        constexpr bool
+        GetSummationChannel( std::uint8_t aChannel ) const NOEXCEPT
+        {
+            return ( iValue & ChannelBit( TSSC1::KMask, aChannel ) ) != 0;
+        }
+
+        constexpr CMaskEnable&
+        SetSummationChannel( std::uint8_t aChannel, bool aEnable ) NOEXCEPT
+        {
+            iValue = aEnable ? iValue | ChannelBit( TSSC1::KMask, aChannel )
+                             : iValue & ~ChannelBit( TSSC1::KMask, aChannel );
+            return *this;
+        }
+    };
+
+    struct CMeasurementSnapshot
+    {
+        CMeasurementSnapshot( ){ };
+
+        std::uint16_t iShuntVoltageRegister[ KChannelNumber ] = { };
+        std::uint16_t iBusVoltageRegister[ KChannelNumber ] = { };
+
+        float iShuntVoltage[ KChannelNumber ] = { };
+        float iBusVoltage[ KChannelNumber ] = { };
+
+        bool iFresh = false;  // Registers hold a conversion completed since the previous read
+    };
+
+    // Per-channel correction: corrected = raw * gain + offset, for shunt and bus voltage.
+    // Gains are in 0..KMaxCalibrationGain, offsets within the full-scale voltage.
+    struct CChannelCalibration
+    {
+        constexpr CChannelCalibration( ){ };
+
+        float iShuntVoltageGain = 1.0f;
+        float iShuntVoltageOffset = 0.0f;  // V
+        float iBusVoltageGain = 1.0f;
+        float iBusVoltageOffset = 0.0f;  // V
+    };
+
+    struct CChannelPower
+    {
+        constexpr CChannelPower( ){ };
+
+        float iShuntVoltage = 0.0f;  // V
+        float iBusVoltage = 0.0f;    // V
+        float iCurrent = 0.0f;       // A
+        float iPower = 0.0f;         // W
+    };
+
+    // Returns true when the device has completed a new conversion (e.g. from a GPIO line)
+    using TConversionReadyCallback = bool ( * )( void* aContext );
+
+    enum class SnapshotReadMode : std::uint8_t
+    {
+        Block,       // Registers 0x01..0x06 in one I2C transaction
+        Sequential,  // One I2C transaction per register (buses without block reads)
+    };
+
+    SnapshotReadMode iSnapshotReadMode = SnapshotReadMode::Block;
+
+    enum class InitMode : std::uint8_t
+    {
+        Reset,  // Always reset the device and write the config
+        // Keep a device already running the config with every other register at its reset
+        // value, e.g. across a process restart
+        WarmStart,
+        // As WarmStart, but keep the limits and alert controls the device holds, e.g. for a
+        // threshold policy that is re-applied afterwards
+        WarmStartKeepLimits,
     };
 
     constexpr CIina3221( AbstractPlatform::IAbstractI2CBus& aI2CBus,
                          std::uint8_t aDeviceAddress = KDefaultAddress ) NOEXCEPT
         : iI2CBus{ aI2CBus },
+          iRawI2CBus{ aI2CBus },
           iDeviceAddress{ aDeviceAddress }
     {
     }
     ~CIina3221( ) = default;
 
-    TErrorCode Init( const CConfig& aConfig = { } ) NOEXCEPT;
+    inline std::uint8_t
+    DeviceAddress( ) const NOEXCEPT
+    {
+        return iDeviceAddress;
+    }
+
+    // Verifies the die ID and brings the device to aConfig. The warm start modes read the
+    // config, limit and mask/enable registers back first and skip the reset when the device
+    // already matches, so running conversions and averaging continue undisturbed and the
+    // measurement registers keep their last results. The values read seed the shadow cache.
+    // Reading mask/enable consumes a pending conversion-ready flag.
+    TErrorCode Init( const CConfig& aConfig = { }, InitMode aInitMode = InitMode::Reset ) NOEXCEPT;
 
     inline TErrorCode
     Reset( ) NOEXCEPT
     {
-        CConfig config;
-        config.iRstart = true;
-        return SetConfig( config ) == AbstractPlatform::KOk;
+        return SetConfig( CConfig{ }.SetReset( true ) );
     }
 
     inline TErrorCode
     Reset( CConfig aConfig ) NOEXCEPT
     {
-        aConfig.iRstart = true;
-        auto result = SetConfig( aConfig ) == AbstractPlatform::KOk;
+        const auto result = SetConfig( aConfig.SetReset( true ) );
         if ( result == AbstractPlatform::KOk )
         {
-            aConfig.iRstart = false;
+            aConfig.SetReset( false );
             return SetConfig( aConfig );
         }
         return result;
@@ -144,6 +412,136 @@ public:
 
     TErrorCode BusVoltageV( float& aVoltage, std::uint8_t aChannel = KChannel1 ) NOEXCEPT;
 
+    // Calibrated voltages (see SetChannelCalibration), the float getters are these in volts
+    TErrorCode ShuntVoltageUv( std::int32_t& aMicroVolts,
+                               std::uint8_t aChannel = KChannel1 ) NOEXCEPT;
+
+    TErrorCode BusVoltageUv( std::int32_t& aMicroVolts,
+                             std::uint8_t aChannel = KChannel1 ) NOEXCEPT;
+
+    // Shunt resistance used by the current getters, 0 means not configured. Currents saturate
+    // at the std::int32_t µA range (about ±2147 A), which full-scale shunt voltage exceeds
+    // below about 76 µΩ.
+    TErrorCode SetShuntResistanceUOhm( std::uint32_t aMicroOhms,
+                                       std::uint8_t aChannel = KChannel1 ) NOEXCEPT;
+
+    TErrorCode CurrentUa( std::int32_t& aMicroAmps, std::uint8_t aChannel = KChannel1 ) NOEXCEPT;
+
+    // aOhms in 0..KMaxShuntResistance, the range of SetShuntResistanceUOhm
+    TErrorCode SetShuntResistance( float aOhms, std::uint8_t aChannel = KChannel1 ) NOEXCEPT;
+
+    static constexpr float KMaxShuntResistance = 4294.0f;
+
+    inline std::uint32_t
+    ShuntResistanceUOhm( std::uint8_t aChannel = KChannel1 ) const NOEXCEPT
+    {
+        return aChannel >= KChannel1 && aChannel <= KChannelNumber
+                   ? iShuntResistanceUOhm[ aChannel - KChannel1 ]
+                   : 0;
+    }
+
+    static constexpr float KMaxCalibrationGain = 2.0f;
+
+    // Applies to every per-channel getter of this class. Snapshots, CReadPlan values and the
+    // static register decoders stay uncalibrated.
+    TErrorCode SetChannelCalibration( const CChannelCalibration& aCalibration,
+                                      std::uint8_t aChannel = KChannel1 ) NOEXCEPT;
+
+    // Calibrated current, requires the channel shunt resistance
+    TErrorCode CurrentA( float& aCurrent, std::uint8_t aChannel = KChannel1 ) NOEXCEPT;
+
+    TErrorCode PowerW( float& aPower, std::uint8_t aChannel = KChannel1 ) NOEXCEPT;
+
+    // Reads shunt and bus voltage of one channel (one block read in SnapshotReadMode::Block)
+    // and derives calibrated current and power from them
+    TErrorCode ReadChannelPower( CChannelPower& aChannelPower,
+                                 std::uint8_t aChannel = KChannel1 ) NOEXCEPT;
+
+    // Integer decode of raw shunt/bus voltage registers (e.g. CMeasurementSnapshot registers)
+    static std::int32_t ShuntRegisterToUv( std::uint16_t aShuntVoltageRegister ) NOEXCEPT;
+
+    static std::int32_t BusRegisterToUv( std::uint16_t aBusVoltageRegister ) NOEXCEPT;
+
+    // Float decode of raw shunt/bus voltage registers, the integer decode in volts
+    static float ShuntRegisterToVolts( std::uint16_t aShuntVoltageRegister ) NOEXCEPT;
+
+    static float BusRegisterToVolts( std::uint16_t aBusVoltageRegister ) NOEXCEPT;
+
+    // Signed LSB counts of a raw shunt or bus voltage register
+    static std::int16_t VoltageRegisterToCounts( std::uint16_t aVoltageRegister ) NOEXCEPT;
+
+    // Fills the registers and uncalibrated voltages of aSnapshot from the measurement registers
+    // in address order, as read by ReadSnapshot. iFresh is left untouched.
+    static void DecodeSnapshot( const std::uint16_t ( &aRegisters )[ KMeasurementRegisterNumber ],
+                                CMeasurementSnapshot& aSnapshot ) NOEXCEPT;
+
+    // Saturated to the std::int32_t range, see SetShuntResistanceUOhm
+    std::int32_t ShuntUvToUa( std::int32_t aMicroVolts, std::uint8_t aChannel ) const NOEXCEPT;
+
+    TErrorCode ReadSnapshot( CMeasurementSnapshot& aSnapshot ) NOEXCEPT;
+
+    // Reads the measurement registers only once a new conversion has finished. Readiness comes
+    // from the conversion-ready callback if one is set, otherwise from the CVRF bit of the
+    // mask/enable register. When no new conversion is available aSnapshot is left untouched
+    // except for iFresh, which is cleared.
+    TErrorCode ReadSnapshotIfReady( CMeasurementSnapshot& aSnapshot ) NOEXCEPT;
+
+    inline void
+    SetConversionReadyCallback( TConversionReadyCallback aCallback,
+                                void* aContext = nullptr ) NOEXCEPT
+    {
+        iConversionReadyCallback = aCallback;
+        iConversionReadyContext = aContext;
+    }
+
+    // Sleeps for at least aMicroseconds (e.g. a low-power timer wait)
+    using TDelayCallback = void ( * )( void* aContext, std::uint32_t aMicroseconds );
+
+    // Lets TriggerAndRead sleep until the conversion deadline, readiness is then checked once
+    // instead of being polled for
+    inline void
+    SetDelayCallback( TDelayCallback aCallback, void* aContext = nullptr ) NOEXCEPT
+    {
+        iDelayCallback = aCallback;
+        iDelayContext = aContext;
+    }
+
+    // Conversion times and averaging used by TriggerAndRead. A single-shot operation mode limits
+    // the conversions to shunt or bus voltage, any other mode converts both.
+    inline void
+    SetTriggerConfig( const CConfig& aConfig ) NOEXCEPT
+    {
+        iTriggerConfig = aConfig;
+        iTriggerChannelMask = KNoTriggerChannelMask;
+    }
+
+    // 0 for channels outside KChannel1..KChannel3
+    static constexpr std::uint8_t
+    ChannelMask( std::uint8_t aChannel ) NOEXCEPT
+    {
+        return IsChannel( aChannel ) ? static_cast< std::uint8_t >( 1u << ( aChannel - KChannel1 ) )
+                                     : 0;
+    }
+
+    static constexpr std::uint8_t KAllChannels = 0x07;
+
+    // Single-shot measurement of the channels in aChannelMask (see ChannelMask): one config write
+    // triggers the conversion, then the call sleeps until its deadline (delay callback set),
+    // waits for readiness (conversion-ready callback or CVRF), and reads only the converted
+    // registers. The device idles once the conversion is done. Registers of other channels in
+    // aSnapshot are left untouched. Fails with KTimeoutError if readiness is not seen within
+    // about twice the conversion time, and with KInvalidArgumentError if a conversion-ready
+    // callback is set without a delay callback to pace its polls.
+    TErrorCode TriggerAndRead( std::uint8_t aChannelMask,
+                               CMeasurementSnapshot& aSnapshot ) NOEXCEPT;
+
+    static std::uint32_t ConversionTimeUs( ConversionTime aConversionTime ) NOEXCEPT;
+
+    static std::uint16_t AveragingSamples( AveragingMode aAveragingMode ) NOEXCEPT;
+
+    // Time between two consecutive CVRF events for the given configuration
+    static std::uint32_t ConversionPeriodUs( const CConfig& aConfig ) NOEXCEPT;
+
     TErrorCode GetShuntCriticalAlertLimit( float& aShuntLimit,
                                            std::uint8_t aChannel = KChannel1 ) NOEXCEPT;
 
@@ -174,6 +572,48 @@ public:
 
     TErrorCode SetPowerValidLowerLimit( float aPowerValidLowerLimit ) NOEXCEPT;
 
+    // Shadow cache of the registers only this driver writes (config, alert limits, sum limit,
+    // mask/enable control bits, power-valid limits): unchanged writes are skipped and reads are
+    // served locally. Disabled by default.
+    void EnableShadowCache( bool aEnable = true ) NOEXCEPT;
+
+    inline bool
+    IsShadowCacheEnabled( ) const NOEXCEPT
+    {
+        return iShadowCacheEnabled;
+    }
+
+    // Drops all cached register values. The next access of every register goes to the device.
+    inline void
+    Invalidate( ) NOEXCEPT
+    {
+        iShadowValidMask = 0;
+    }
+
+    // Reloads all cached register values from the device.
+    TErrorCode Resync( ) NOEXCEPT;
+
+    // Stages configuration register writes and commits them in a safe order, see below
+    class CTransaction;
+
+    // Reads a fixed set of registers each cycle with a precomputed transaction plan, see below
+    class CReadPlan;
+
+#ifdef INA3221_INSTRUMENTATION
+    // Per-register transaction counts, latency histograms and error counters
+    inline CIna3221Instrumentation&
+    Instrumentation( ) NOEXCEPT
+    {
+        return iInstrumentation;
+    }
+
+    inline const CIna3221Instrumentation&
+    Instrumentation( ) const NOEXCEPT
+    {
+        return iInstrumentation;
+    }
+#endif
+
 #ifdef __EXCEPTIONS
     inline float
     ShuntVoltageV( std::uint8_t aChannel = KChannel1 )
@@ -209,11 +649,74 @@ public:
 #endif
 
 private:
+    // Bit of aChannel in a per-channel bit group that descends from the channel 1 bit
+    // aChannel1Mask, 0 for channels outside KChannel1..KChannel3
+    static constexpr std::uint16_t
+    ChannelBit( std::uint16_t aChannel1Mask, std::uint8_t aChannel ) NOEXCEPT
+    {
+        return IsChannel( aChannel )
+                   ? static_cast< std::uint16_t >( aChannel1Mask >> ( aChannel - KChannel1 ) )
+                   : 0;
+    }
+
     /* data */
     AbstractPlatform::CI2CBus iI2CBus;
+    AbstractPlatform::IAbstractI2CBus& iRawI2CBus;  // Block reads of run-time length
     const std::uint8_t iDeviceAddress;
     std::uint8_t iLastRegisterAddress = 0x00;
 
+    static constexpr std::uint8_t KShadowRegisterNumber = 11;
+
+    bool iShadowCacheEnabled = false;
+    std::uint16_t iShadowValidMask = 0;
+    std::uint16_t iShadowRegisters[ KShadowRegisterNumber ] = { };
+
+    // Shunt voltage to current factor, µA per µV scaled by KCurrentScaleOne
+    static constexpr std::int64_t KCurrentScaleOne = std::int64_t{ 1 } << 24;
+
+    std::uint32_t iShuntResistanceUOhm[ KChannelNumber ] = { };
+    std::int64_t iCurrentScale[ KChannelNumber ] = { };
+
+    // Calibration applied to the microvolt decode: gains scaled by KCurrentScaleOne
+    struct CChannelScale
+    {
+        std::int64_t iShuntVoltageGain = KCurrentScaleOne;
+        std::int32_t iShuntVoltageOffsetUv = 0;
+        std::int64_t iBusVoltageGain = KCurrentScaleOne;
+        std::int32_t iBusVoltageOffsetUv = 0;
+    };
+
+    CChannelScale iChannelScale[ KChannelNumber ];
+
+    static std::int32_t Calibrate( std::int32_t aMicroVolts,
+                                   std::int64_t aGain,
+                                   std::int32_t aOffsetUv ) NOEXCEPT;
+
+    TConversionReadyCallback iConversionReadyCallback = nullptr;
+    void* iConversionReadyContext = nullptr;
+
+    TDelayCallback iDelayCallback = nullptr;
+    void* iDelayContext = nullptr;
+
+    // Single-shot trigger config cached per channel mask, with its conversion time
+    static constexpr std::uint8_t KNoTriggerChannelMask = 0xFF;
+
+    CConfig iTriggerConfig;
+    std::uint8_t iTriggerChannelMask = KNoTriggerChannelMask;
+    std::uint16_t iTriggerConfigRegister = 0;
+    std::uint32_t iTriggerConversionUs = 0;
+
+    TErrorCode WaitForTriggeredConversion( ) NOEXCEPT;
+
+    // Sets aRunning if the device already runs aConfig (see InitMode)
+    TErrorCode CheckWarmStart( const CConfig& aConfig,
+                               bool aKeepLimits,
+                               bool& aRunning ) NOEXCEPT;
+
+#ifdef INA3221_INSTRUMENTATION
+    CIna3221Instrumentation iInstrumentation;
+#endif
+
     template < typename taRegisterType >
 
     TErrorCode ReadRegister( std::uint8_t aReg, taRegisterType& aRegisterValue ) NOEXCEPT;
@@ -221,25 +724,172 @@ private:
 
     TErrorCode WriteRegister( std::uint8_t aReg, taRegisterType aRegisterValue ) NOEXCEPT;
 
-    template < std::uint8_t taMultiRegisterOffset, std::uint8_t taMultiRegisterPeriod >
+    TErrorCode ReadShadowedRegister( std::uint8_t aReg, std::uint16_t& aRegisterValue ) NOEXCEPT;
+    TErrorCode WriteShadowedRegister( std::uint8_t aReg, std::uint16_t aRegisterValue ) NOEXCEPT;
+    void UpdateShadow( std::uint8_t aReg, std::uint16_t aRegisterValue ) NOEXCEPT;
+
+    // One read transaction over aRegisterCount (1..255) consecutive registers, not past 0xFF
+    TErrorCode ReadRegisterBlock( std::uint8_t aFirstReg,
+                                  std::uint16_t* aRegisterValues,
+                                  std::size_t aRegisterCount ) NOEXCEPT;
+
+    template < typename taRegister >
     inline TErrorCode GetVoltageRegister( std::uint16_t& aVoltageRegister,
                                           std::uint8_t aChannel ) NOEXCEPT;
-    template < std::uint8_t taMultiRegisterOffset, std::uint8_t taMultiRegisterPeriod >
+    template < typename taRegister >
     inline TErrorCode SetVoltageRegister( std::uint16_t aVoltageRegister,
                                           std::uint8_t aChannel ) NOEXCEPT;
 
-    template < std::uint8_t taMultiRegisterOffset,
-               std::uint8_t taMultiRegisterPeriod,
-               std::uint8_t taDataLShift = 3 >
-    inline TErrorCode GetVoltageRegister( float& aVoltage,
-                                          float aMaxAbsoluteVoltage,
-                                          std::uint8_t aChannel ) NOEXCEPT;
-    template < std::uint8_t taMultiRegisterOffset,
-               std::uint8_t taMultiRegisterPeriod,
-               std::uint8_t taDataLShift = 3 >
-    inline TErrorCode SetVoltageRegister( float aVoltage,
-                                          float aMaxAbsoluteVoltage,
-                                          std::uint8_t aChannel ) NOEXCEPT;
+    template < typename taRegister, std::int32_t taFullScaleMicroVolts >
+    inline TErrorCode GetVoltageRegister( float& aVoltage, std::uint8_t aChannel ) NOEXCEPT;
+    template < typename taRegister, std::int32_t taFullScaleMicroVolts >
+    inline TErrorCode SetVoltageRegister( float aVoltage, std::uint8_t aChannel ) NOEXCEPT;
+};
+
+// Collects typed configuration writes and commits them with one write per changed register.
+// Staging a register twice keeps the last value. Commit writes an optional reset first, then the
+// alert and power-valid limits, then mask/enable and the config register last, so alerts are
+// never enabled against stale limits and conversions start only once everything is in place.
+// With the shadow cache enabled, registers that already hold the staged value are not written.
+class CIina3221::CTransaction
+{
+public:
+    explicit CTransaction( CIina3221& aDevice ) NOEXCEPT
+        : iDevice{ aDevice }
+    {
+    }
+
+    // Resets the device before any staged value is written
+    CTransaction& Reset( ) NOEXCEPT;
+
+    // A config with the reset bit set is staged as Reset() plus the config without that bit
+    CTransaction& SetConfig( const CConfig& aConfig ) NOEXCEPT;
+
+    CTransaction& SetMaskEnable( const CMaskEnable& aMaskEnable ) NOEXCEPT;
+
+    CTransaction& SetShuntCriticalAlertLimit( float aShuntLimit,
+                                              std::uint8_t aChannel = KChannel1 ) NOEXCEPT;
+
+    CTransaction& SetShuntWarningAlertLimit( float aShuntLimit,
+                                             std::uint8_t aChannel = KChannel1 ) NOEXCEPT;
+
+    CTransaction& SetShuntVoltageSumLimit( float aShuntSumLimit ) NOEXCEPT;
+
+    CTransaction& SetPowerValidUpperLimit( float aPowerValidUpperLimit ) NOEXCEPT;
+
+    CTransaction& SetPowerValidLowerLimit( float aPowerValidLowerLimit ) NOEXCEPT;
+
+    // Writes the staged registers, stopping at the first failure. Written registers leave the
+    // staged set, so a failed commit can be retried.
+    TErrorCode Commit( ) NOEXCEPT;
+
+    void Clear( ) NOEXCEPT;
+
+    // Register address of the write that failed the last Commit (or the staging call that was
+    // rejected), KNoRegister if none
+    inline std::uint8_t
+    FailedRegister( ) const NOEXCEPT
+    {
+        return iFailedRegister;
+    }
+
+    static constexpr std::uint8_t KNoRegister = 0xFF;
+
+private:
+    CIina3221& iDevice;
+    std::uint16_t iValues[ KShadowRegisterNumber ] = { };
+    std::uint16_t iStagedMask = 0;
+    bool iReset = false;
+    TErrorCode iStagingError = AbstractPlatform::KOk;
+    std::uint8_t iFailedRegister = KNoRegister;
+
+    CTransaction& Stage( std::uint8_t aRegisterAddress, std::uint16_t aRegisterValue ) NOEXCEPT;
+    CTransaction& RejectChannel( std::uint8_t aRegisterAddress ) NOEXCEPT;
+};
+
+// Reads the same set of registers every cycle with as few transactions and register pointer
+// writes as possible. The requested registers are planned once into spans: adjacent registers
+// share one block read, and a single unrequested register between two spans is read through
+// rather than paying for another pointer write, unless reading it has side effects
+// (mask/enable). Execute starts with the span the device register pointer already selects, so a
+// one-span plan never writes the pointer and a plan of N spans writes it at most N - 1 times.
+// In SnapshotReadMode::Sequential every requested register is a span of its own.
+class CIina3221::CReadPlan
+{
+public:
+    // Plannable registers: config up to the power-valid lower limit
+    static constexpr std::uint8_t KRegisterNumber
+        = Ina3221::CRegisterMap::TPowerValidLowerLimit::KAddress + 1;
+
+    static constexpr std::uint8_t KNoRegister = 0xFF;
+
+    explicit CReadPlan( CIina3221& aDevice ) NOEXCEPT
+        : iDevice{ aDevice }
+    {
+    }
+
+    CReadPlan& AddRegister( std::uint8_t aRegisterAddress ) NOEXCEPT;
+
+    CReadPlan& AddShuntVoltage( std::uint8_t aChannel = KChannel1 ) NOEXCEPT;
+
+    CReadPlan& AddBusVoltage( std::uint8_t aChannel = KChannel1 ) NOEXCEPT;
+
+    CReadPlan& AddShuntVoltageSum( ) NOEXCEPT;
+
+    CReadPlan& AddMaskEnable( ) NOEXCEPT;
+
+    // Computes the plan now instead of on the next Execute. Returns the transactions per cycle.
+    std::uint8_t Plan( ) NOEXCEPT;
+
+    // Reads all requested registers, stopping at the first failed transaction. Spans read
+    // before a failure keep their new values.
+    TErrorCode Execute( ) NOEXCEPT;
+
+    void Clear( ) NOEXCEPT;
+
+    // Register value from the last Execute, 0 for addresses outside the plannable registers
+    inline std::uint16_t
+    Value( std::uint8_t aRegisterAddress ) const NOEXCEPT
+    {
+        return aRegisterAddress < KRegisterNumber ? iValues[ aRegisterAddress ] : 0;
+    }
+
+    std::int32_t ShuntVoltageUv( std::uint8_t aChannel = KChannel1 ) const NOEXCEPT;
+
+    std::int32_t BusVoltageUv( std::uint8_t aChannel = KChannel1 ) const NOEXCEPT;
+
+    inline CMaskEnable
+    MaskEnable( ) const NOEXCEPT
+    {
+        return CMaskEnable{ Value( Ina3221::CRegisterMap::TMaskEnable::KAddress ) };
+    }
+
+    // First register of the span that failed the last Execute (or the rejected register of an
+    // Add call), KNoRegister if none
+    inline std::uint8_t
+    FailedRegister( ) const NOEXCEPT
+    {
+        return iFailedRegister;
+    }
+
+private:
+    struct CSpan
+    {
+        std::uint8_t iFirst;
+        std::uint8_t iCount;
+    };
+
+    CIina3221& iDevice;
+    std::uint32_t iRequestedMask = 0;  // Bit per register address
+    bool iPlanned = false;
+    SnapshotReadMode iPlannedReadMode = SnapshotReadMode::Block;
+    std::uint8_t iSpanNumber = 0;
+    CSpan iSpans[ KRegisterNumber ] = { };
+    std::uint16_t iValues[ KRegisterNumber ] = { };
+    TErrorCode iStagingError = AbstractPlatform::KOk;
+    std::uint8_t iFailedRegister = KNoRegister;
+
+    CReadPlan& Reject( std::uint8_t aRegisterAddress ) NOEXCEPT;
 };
 
 }  // namespace ExternalHardware
\ No newline at end of file
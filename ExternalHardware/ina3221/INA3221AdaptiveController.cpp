@@ -0,0 +1,259 @@
+#include <ExternalHardware/ina3221/INA3221AdaptiveController.hpp>
+
+namespace ExternalHardware
+{
+namespace
+{
+struct CStep
+{
+    CIina3221::ConversionTime iConversionTime;
+    CIina3221::AveragingMode iAveragingMode;
+};
+
+// Fast conversions first, then averaging at the default conversion time
+constexpr CStep KSteps[ CIna3221AdaptiveController::KStepNumber ] = {
+    { CIina3221::ConversionTime::t140us, CIina3221::AveragingMode::avg1 },
+    { CIina3221::ConversionTime::t204us, CIina3221::AveragingMode::avg1 },
+    { CIina3221::ConversionTime::t332us, CIina3221::AveragingMode::avg1 },
+    { CIina3221::ConversionTime::t588us, CIina3221::AveragingMode::avg1 },
+    { CIina3221::ConversionTime::t1100us, CIina3221::AveragingMode::avg1 },
+    { CIina3221::ConversionTime::t1100us, CIina3221::AveragingMode::avg4 },
+    { CIina3221::ConversionTime::t1100us, CIina3221::AveragingMode::avg16 },
+    { CIina3221::ConversionTime::t1100us, CIina3221::AveragingMode::avg64 },
+    { CIina3221::ConversionTime::t1100us, CIina3221::AveragingMode::avg128 },
+    { CIina3221::ConversionTime::t1100us, CIina3221::AveragingMode::avg256 },
+    { CIina3221::ConversionTime::t1100us, CIina3221::AveragingMode::avg512 },
+    { CIina3221::ConversionTime::t1100us, CIina3221::AveragingMode::avg1024 },
+};
+
+// Float LSB, so noise ceilings divide without truncation
+constexpr float KShuntVoltageLsbUv = static_cast< float >( CIina3221::KShuntVoltageLsbUv );
+
+}  // namespace
+
+CIna3221AdaptiveController::CIna3221AdaptiveController(
+    CIina3221& aDevice,
+    const CIina3221::CConfig& aBaseConfig ) NOEXCEPT
+    : iDevice{ aDevice },
+      iBaseConfig{ aBaseConfig },
+      iConfig{ aBaseConfig }
+{
+}
+
+CIina3221::CConfig
+CIna3221AdaptiveController::StepConfig( CIina3221::CConfig aBaseConfig,
+                                        std::uint8_t aStep ) NOEXCEPT
+{
+    const auto& step = KSteps[ aStep < KStepNumber ? aStep : KStepNumber - 1 ];
+    aBaseConfig.SetShuntVoltageConversionTime( step.iConversionTime )
+        .SetBusVoltageConversionTime( step.iConversionTime )
+        .SetAveragingMode( step.iAveragingMode )
+        .SetReset( false );
+    return aBaseConfig;
+}
+
+std::uint32_t
+CIna3221AdaptiveController::IntegrationTimeUs( std::uint8_t aStep ) NOEXCEPT
+{
+    const auto& step = KSteps[ aStep < KStepNumber ? aStep : KStepNumber - 1 ];
+    return CIina3221::ConversionTimeUs( step.iConversionTime )
+           * CIina3221::AveragingSamples( step.iAveragingMode );
+}
+
+CIna3221AdaptiveController::TErrorCode
+CIna3221AdaptiveController::SetBudget( const CBudget& aBudget ) NOEXCEPT
+{
+    if ( !( aBudget.iMinSampleRateHz > 0.0f ) || !( aBudget.iTransientFactor > 1.0f )
+         || aBudget.iWindowSamples < 2 )
+    {
+        return AbstractPlatform::KInvalidArgumentError;
+    }
+    for ( const auto ceiling : aBudget.iNoiseCeilingUv )
+    {
+        if ( ceiling < 0 )
+        {
+            return AbstractPlatform::KInvalidArgumentError;
+        }
+    }
+
+    iBudget = aBudget;
+    ResetWindow( );
+    return AbstractPlatform::KOk;
+}
+
+CIna3221AdaptiveController::TErrorCode
+CIna3221AdaptiveController::Start( ) NOEXCEPT
+{
+    iQuietWindows = 0;
+    iPreviousMeanValid = false;
+    ResetWindow( );
+
+    return ApplyStep( SlowestStepForRate( ) );
+}
+
+CIna3221AdaptiveController::TErrorCode
+CIna3221AdaptiveController::Update( const CIina3221::CMeasurementSnapshot& aSnapshot ) NOEXCEPT
+{
+    if ( !aSnapshot.iFresh )
+    {
+        return AbstractPlatform::KOk;
+    }
+    if ( iSkipNextSample )
+    {
+        // May hold a conversion started with the previous settings
+        iSkipNextSample = false;
+        return AbstractPlatform::KOk;
+    }
+
+    for ( std::uint8_t index = 0; index < CIina3221::KChannelNumber; ++index )
+    {
+        const std::int64_t counts
+            = CIina3221::VoltageRegisterToCounts( aSnapshot.iShuntVoltageRegister[ index ] );
+        iWindow[ index ].iSum += counts;
+        iWindow[ index ].iSumOfSquares += counts * counts;
+    }
+
+    if ( ++iWindowCount < iBudget.iWindowSamples )
+    {
+        return AbstractPlatform::KOk;
+    }
+    return EvaluateWindow( );
+}
+
+bool
+CIna3221AdaptiveController::ChannelTracked( std::uint8_t aChannelIndex ) const NOEXCEPT
+{
+    return iBudget.iNoiseCeilingUv[ aChannelIndex ] > 0
+           && iBaseConfig.GetChannelEnable( static_cast< std::uint8_t >( aChannelIndex + 1 ) );
+}
+
+std::uint8_t
+CIna3221AdaptiveController::SlowestStepForRate( ) const NOEXCEPT
+{
+    const float maxPeriodUs = 1e6f / iBudget.iMinSampleRateHz;
+    std::uint8_t step = 0;
+    while ( step + 1 < KStepNumber
+            && static_cast< float >( CIina3221::ConversionPeriodUs(
+                   StepConfig( iBaseConfig, static_cast< std::uint8_t >( step + 1 ) ) ) )
+                   <= maxPeriodUs )
+    {
+        ++step;
+    }
+    return step;
+}
+
+std::uint8_t
+CIna3221AdaptiveController::FastestStepForNoise( ) const NOEXCEPT
+{
+    for ( std::uint8_t step = 0; step < KStepNumber; ++step )
+    {
+        bool fits = true;
+        for ( std::uint8_t index = 0; index < CIina3221::KChannelNumber && fits; ++index )
+        {
+            if ( !ChannelTracked( index ) || iNoiseDensity[ index ] < 0.0f )
+            {
+                continue;
+            }
+            const float ceilingCounts = iBudget.iNoiseCeilingUv[ index ] / KShuntVoltageLsbUv;
+            fits = iNoiseDensity[ index ] / IntegrationTimeUs( step )
+                   <= ceilingCounts * ceilingCounts;
+        }
+        if ( fits )
+        {
+            return step;
+        }
+    }
+    return KStepNumber - 1;
+}
+
+CIna3221AdaptiveController::TErrorCode
+CIna3221AdaptiveController::EvaluateWindow( ) NOEXCEPT
+{
+    const float samples = iWindowCount;
+    bool transient = false;
+    float mean[ CIina3221::KChannelNumber ] = { };
+    float variance[ CIina3221::KChannelNumber ] = { };
+
+    for ( std::uint8_t index = 0; index < CIina3221::KChannelNumber; ++index )
+    {
+        mean[ index ] = iWindow[ index ].iSum / samples;
+        variance[ index ]
+            = ( iWindow[ index ].iSumOfSquares - iWindow[ index ].iSum * mean[ index ] )
+              / ( samples - 1.0f );
+        if ( !ChannelTracked( index ) )
+        {
+            continue;
+        }
+
+        const float threshold
+            = iBudget.iTransientFactor * iBudget.iNoiseCeilingUv[ index ] / KShuntVoltageLsbUv;
+        const float meanShift = mean[ index ] - iPreviousMean[ index ];
+        if ( ( iPreviousMeanValid && ( meanShift > threshold || -meanShift > threshold ) )
+             || variance[ index ] > threshold * threshold )
+        {
+            transient = true;
+        }
+    }
+
+    for ( std::uint8_t index = 0; index < CIina3221::KChannelNumber; ++index )
+    {
+        iPreviousMean[ index ] = mean[ index ];
+        if ( !transient )
+        {
+            // Only quiet windows measure noise, a load step would be taken for noise
+            iNoiseDensity[ index ] = variance[ index ] * IntegrationTimeUs( iStep );
+        }
+    }
+    iPreviousMeanValid = true;
+    ResetWindow( );
+
+    const auto rateStep = SlowestStepForRate( );
+    const auto noiseStep = FastestStepForNoise( );
+    iNoiseBudgetExceeded = noiseStep > rateStep;
+    const auto fastestFit = noiseStep < rateStep ? noiseStep : rateStep;
+
+    if ( transient )
+    {
+        iQuietWindows = 0;
+        return fastestFit < iStep ? ApplyStep( fastestFit ) : AbstractPlatform::KOk;
+    }
+    if ( iStep > rateStep || iStep < fastestFit )
+    {
+        // Budget changed or too noisy, no hysteresis
+        iQuietWindows = 0;
+        return ApplyStep( iStep > rateStep ? rateStep : fastestFit );
+    }
+    if ( iStep < rateStep && ++iQuietWindows >= iBudget.iReleaseWindows )
+    {
+        iQuietWindows = 0;
+        return ApplyStep( static_cast< std::uint8_t >( iStep + 1 ) );
+    }
+    return AbstractPlatform::KOk;
+}
+
+CIna3221AdaptiveController::TErrorCode
+CIna3221AdaptiveController::ApplyStep( std::uint8_t aStep ) NOEXCEPT
+{
+    const auto config = StepConfig( iBaseConfig, aStep );
+    const auto result = iDevice.SetConfig( config );
+    if ( result == AbstractPlatform::KOk )
+    {
+        iStep = aStep;
+        iConfig = config;
+        iSkipNextSample = true;
+        ++iReconfigurationCount;
+    }
+    return result;
+}
+
+void
+CIna3221AdaptiveController::ResetWindow( ) NOEXCEPT
+{
+    iWindowCount = 0;
+    for ( auto& window : iWindow )
+    {
+        window = CWindow{ };
+    }
+}
+
+}  // namespace ExternalHardware
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <ExternalHardware/ina3221/INA3221.hpp>
+
+namespace ExternalHardware
+{
+// Retunes conversion time and averaging of one CIina3221 to a sample-rate and noise budget.
+//
+// Settings form a ladder of steps with increasing integration time (conversion time times
+// averaged samples), so each step is slower and quieter than the one below. Fresh snapshots are
+// fed through Update and evaluated per window of samples:
+// - a load step (window mean moving, or the spread within a window, above the transient
+//   threshold) drops immediately to the fastest step whose predicted noise fits the ceiling
+// - a noisy window steps up immediately to the first step predicted to fit the ceiling
+// - after iReleaseWindows quiet windows the controller moves one step slower, up to the slowest
+//   step that still meets the sample rate
+// The sample rate always wins over the noise ceiling, NoiseBudgetExceeded reports the conflict.
+// Noise is predicted from the last quiet window assuming white noise, i.e. the variance scales
+// with the inverse of the integration time.
+class CIna3221AdaptiveController
+{
+public:
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    static constexpr std::uint8_t KStepNumber = 12;
+
+    struct CBudget
+    {
+        constexpr CBudget( ){ };
+
+        float iMinSampleRateHz = 100.0f;  // Effective rate of complete snapshots
+        // Shunt voltage standard deviation ceiling per channel, 0 ignores the channel
+        std::int32_t iNoiseCeilingUv[ CIina3221::KChannelNumber ] = { 200, 200, 200 };
+        float iTransientFactor = 4.0f;      // Transient threshold in noise ceilings
+        std::uint16_t iWindowSamples = 16;  // Snapshots per evaluation window
+        std::uint8_t iReleaseWindows = 4;   // Quiet windows before each step towards slower
+    };
+
+    // aBaseConfig provides the operating mode and enabled channels, conversion times and
+    // averaging are overridden by the controller
+    CIna3221AdaptiveController( CIina3221& aDevice,
+                                const CIina3221::CConfig& aBaseConfig ) NOEXCEPT;
+
+    TErrorCode SetBudget( const CBudget& aBudget ) NOEXCEPT;
+
+    inline const CBudget&
+    Budget( ) const NOEXCEPT
+    {
+        return iBudget;
+    }
+
+    // Writes the slowest step that meets the sample rate and starts a new window
+    TErrorCode Start( ) NOEXCEPT;
+
+    // Feeds a snapshot, stale ones (iFresh == false) are ignored. Writes the config register
+    // when the step changes.
+    TErrorCode Update( const CIina3221::CMeasurementSnapshot& aSnapshot ) NOEXCEPT;
+
+    inline std::uint8_t
+    Step( ) const NOEXCEPT
+    {
+        return iStep;
+    }
+
+    inline const CIina3221::CConfig&
+    Config( ) const NOEXCEPT
+    {
+        return iConfig;
+    }
+
+    inline bool
+    NoiseBudgetExceeded( ) const NOEXCEPT
+    {
+        return iNoiseBudgetExceeded;
+    }
+
+    inline std::uint32_t
+    ReconfigurationCount( ) const NOEXCEPT
+    {
+        return iReconfigurationCount;
+    }
+
+    // aBaseConfig with the conversion times and averaging of aStep
+    static CIina3221::CConfig StepConfig( CIina3221::CConfig aBaseConfig,
+                                          std::uint8_t aStep ) NOEXCEPT;
+
+    // Shunt conversion time times averaged samples of aStep
+    static std::uint32_t IntegrationTimeUs( std::uint8_t aStep ) NOEXCEPT;
+
+private:
+    struct CWindow
+    {
+        std::int64_t iSum = 0;
+        std::int64_t iSumOfSquares = 0;
+    };
+
+    CIina3221& iDevice;
+    const CIina3221::CConfig iBaseConfig;
+    CIina3221::CConfig iConfig;
+    CBudget iBudget;
+
+    std::uint8_t iStep = 0;
+    std::uint8_t iQuietWindows = 0;
+    bool iNoiseBudgetExceeded = false;
+    bool iSkipNextSample = false;
+    std::uint32_t iReconfigurationCount = 0;
+
+    std::uint16_t iWindowCount = 0;
+    CWindow iWindow[ CIina3221::KChannelNumber ];
+    bool iPreviousMeanValid = false;
+    float iPreviousMean[ CIina3221::KChannelNumber ] = { };  // Counts
+    // Variance times integration time in counts^2 * µs, negative if not measured yet
+    float iNoiseDensity[ CIina3221::KChannelNumber ] = { -1.0f, -1.0f, -1.0f };
+
+    bool ChannelTracked( std::uint8_t aChannelIndex ) const NOEXCEPT;
+    std::uint8_t SlowestStepForRate( ) const NOEXCEPT;
+    std::uint8_t FastestStepForNoise( ) const NOEXCEPT;
+    TErrorCode EvaluateWindow( ) NOEXCEPT;
+    TErrorCode ApplyStep( std::uint8_t aStep ) NOEXCEPT;
+    void ResetWindow( ) NOEXCEPT;
+};
+
+}  // namespace ExternalHardware
@@ -0,0 +1,174 @@
+#include <ExternalHardware/ina3221/INA3221AlertEngine.hpp>
+
+namespace ExternalHardware
+{
+namespace
+{
+using CMaskEnable = CIina3221::CMaskEnable;
+using EventType = CIna3221AlertEngine::EventType;
+
+enum class Latch : std::uint8_t
+{
+    None,
+    Critical,  // Latched while CEN is set
+    Warning,   // Latched while WEN is set
+};
+
+struct CFlag
+{
+    std::uint16_t iMask;
+    EventType iType;
+    std::uint8_t iChannel;
+    Latch iLatch;
+};
+
+// Edge-tracked status flags in dispatch order, most severe first
+constexpr CFlag KFlags[] = {
+    { CMaskEnable::TCF1::KMask, EventType::CriticalAlert, CIina3221::KChannel1, Latch::Critical },
+    { CMaskEnable::TCF2::KMask, EventType::CriticalAlert, CIina3221::KChannel2, Latch::Critical },
+    { CMaskEnable::TCF3::KMask, EventType::CriticalAlert, CIina3221::KChannel3, Latch::Critical },
+    { CMaskEnable::TSF::KMask, EventType::SummationAlert, 0, Latch::Critical },
+    { CMaskEnable::TWF1::KMask, EventType::WarningAlert, CIina3221::KChannel1, Latch::Warning },
+    { CMaskEnable::TWF2::KMask, EventType::WarningAlert, CIina3221::KChannel2, Latch::Warning },
+    { CMaskEnable::TWF3::KMask, EventType::WarningAlert, CIina3221::KChannel3, Latch::Warning },
+    { CMaskEnable::TPVF::KMask, EventType::PowerValid, 0, Latch::None },
+    { CMaskEnable::TTCF::KMask, EventType::TimingControl, 0, Latch::None },
+};
+
+}  // namespace
+
+CIna3221AlertEngine::CIna3221AlertEngine( CIina3221& aDevice ) NOEXCEPT
+    : iDevice{ aDevice }
+{
+}
+
+CIna3221AlertEngine::TErrorCode
+CIna3221AlertEngine::RegisterHandler( TEventHandler aHandler,
+                                      void* aContext,
+                                      std::uint8_t aEventMask ) NOEXCEPT
+{
+    if ( aHandler == nullptr )
+    {
+        return AbstractPlatform::KInvalidArgumentError;
+    }
+    for ( auto& handler : iHandlers )
+    {
+        if ( handler.iHandler == nullptr )
+        {
+            handler.iHandler = aHandler;
+            handler.iContext = aContext;
+            handler.iEventMask = aEventMask;
+            return AbstractPlatform::KOk;
+        }
+    }
+    return AbstractPlatform::KGenericError;
+}
+
+void
+CIna3221AlertEngine::UnregisterHandler( TEventHandler aHandler, void* aContext ) NOEXCEPT
+{
+    for ( auto& handler : iHandlers )
+    {
+        if ( handler.iHandler == aHandler && handler.iContext == aContext )
+        {
+            handler = CHandler{ };
+        }
+    }
+}
+
+CIna3221AlertEngine::TErrorCode
+CIna3221AlertEngine::Process( ) NOEXCEPT
+{
+    if ( !iAlertPending.exchange( false, std::memory_order_acquire ) )
+    {
+        return AbstractPlatform::KOk;
+    }
+    const auto result = Service( );
+    if ( result != AbstractPlatform::KOk )
+    {
+        // Retry on the next Process, the alert condition has not been consumed
+        NotifyAlert( );
+    }
+    return result;
+}
+
+CIna3221AlertEngine::TErrorCode
+CIna3221AlertEngine::Service( ) NOEXCEPT
+{
+    CMaskEnable maskEnable;
+    const auto result = iDevice.GetMaskEnable( maskEnable );
+    if ( result != AbstractPlatform::KOk )
+    {
+        return result;
+    }
+    iLastMaskEnable = maskEnable;
+
+    const auto flags = maskEnable.Value( );
+    const bool conversionReady = maskEnable.GetConversionReady( );
+    const bool criticalLatched = maskEnable.GetCriticalLatchEnable( );
+    const bool warningLatched = maskEnable.GetWarningLatchEnable( );
+
+    for ( const auto& flag : KFlags )
+    {
+        const bool set = ( flags & flag.iMask ) != 0;
+        const bool active = ( iActiveFlags & flag.iMask ) != 0;
+        if ( set == active )
+        {
+            continue;
+        }
+
+        // A latched flag reads back clear right after the read that reported it, only a newer
+        // conversion tells whether the condition is gone
+        const bool latched = ( flag.iLatch == Latch::Critical && criticalLatched )
+                             || ( flag.iLatch == Latch::Warning && warningLatched );
+        if ( !set && latched && !conversionReady )
+        {
+            continue;
+        }
+
+        iActiveFlags = static_cast< std::uint16_t >( iActiveFlags ^ flag.iMask );
+        Dispatch( CEvent{ flag.iType, flag.iChannel, set, maskEnable } );
+    }
+
+    if ( conversionReady )
+    {
+        iConversionReady = true;
+        Dispatch( CEvent{ EventType::ConversionReady, 0, true, maskEnable } );
+    }
+    return AbstractPlatform::KOk;
+}
+
+bool
+CIna3221AlertEngine::ConsumeConversionReady( ) NOEXCEPT
+{
+    const bool conversionReady = iConversionReady;
+    iConversionReady = false;
+    return conversionReady;
+}
+
+bool
+CIna3221AlertEngine::ConversionReady( void* aContext ) NOEXCEPT
+{
+    auto& engine = *static_cast< CIna3221AlertEngine* >( aContext );
+    if ( !engine.iConversionReady )
+    {
+        // A failed read leaves the conversion pending for the next poll
+        engine.Service( );
+    }
+    return engine.ConsumeConversionReady( );
+}
+
+void
+CIna3221AlertEngine::Dispatch( const CEvent& aEvent ) const NOEXCEPT
+{
+    const auto mask = EventMask( aEvent.iType );
+    for ( const auto& handler : iHandlers )
+    {
+        if ( handler.iHandler != nullptr && ( handler.iEventMask & mask ) != 0 )
+        {
+            handler.iHandler( handler.iContext, aEvent );
+        }
+    }
+}
+
+}  // namespace ExternalHardware
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <ExternalHardware/ina3221/INA3221.hpp>
+
+namespace ExternalHardware
+{
+// Turns the mask/enable flags of one CIina3221 into typed edge events for registered handlers.
+//
+// Each Service call reads mask/enable once and compares the flags with the tracked state. A flag
+// going up dispatches an assert event, going down a clear event. Flags latched by the device
+// (critical and summation with CEN, warning with WEN) are cleared by that read, so their clear
+// event is only dispatched once a later read also reports a completed conversion (CVRF) without
+// the flag. Power-valid and timing-control are never latched.
+//
+// Drive it from the alert GPIO (NotifyAlert from the interrupt, Process from a task) or poll
+// Service at a low rate. Since reads clear the latched flags, other consumers should use the
+// engine (State, ConversionReady) instead of reading mask/enable themselves.
+class CIna3221AlertEngine
+{
+public:
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    enum class EventType : std::uint8_t
+    {
+        CriticalAlert,    // CF1..CF3, per channel
+        WarningAlert,     // WF1..WF3, per channel
+        SummationAlert,   // SF
+        PowerValid,       // PVF, asserted while all bus voltages are within the limits
+        TimingControl,    // TCF
+        ConversionReady,  // CVRF, asserted once per read that saw a completed conversion
+    };
+
+    struct CEvent
+    {
+        EventType iType;
+        std::uint8_t iChannel;  // KChannel1..KChannel3 for per-channel events, 0 otherwise
+        bool iAsserted;
+        CIina3221::CMaskEnable iMaskEnable;  // Register value the event was decoded from
+    };
+
+    using TEventHandler = void ( * )( void* aContext, const CEvent& aEvent );
+
+    static constexpr std::uint8_t KMaxHandlerNumber = 8;
+
+    static constexpr std::uint8_t
+    EventMask( EventType aType ) NOEXCEPT
+    {
+        return static_cast< std::uint8_t >( 1u << static_cast< std::uint8_t >( aType ) );
+    }
+
+    static constexpr std::uint8_t KAllEvents = 0x3F;
+
+    explicit CIna3221AlertEngine( CIina3221& aDevice ) NOEXCEPT;
+
+    CIna3221AlertEngine( const CIna3221AlertEngine& ) = delete;
+    CIna3221AlertEngine& operator=( const CIna3221AlertEngine& ) = delete;
+
+    // aHandler receives the events selected by aEventMask (see EventMask)
+    TErrorCode RegisterHandler( TEventHandler aHandler,
+                                void* aContext = nullptr,
+                                std::uint8_t aEventMask = KAllEvents ) NOEXCEPT;
+
+    void UnregisterHandler( TEventHandler aHandler, void* aContext = nullptr ) NOEXCEPT;
+
+    // Interrupt safe, marks the alert as pending for the next Process call
+    inline void
+    NotifyAlert( ) NOEXCEPT
+    {
+        iAlertPending.store( true, std::memory_order_release );
+    }
+
+    // Services the device if NotifyAlert was called since the last Process
+    TErrorCode Process( ) NOEXCEPT;
+
+    // Reads mask/enable once and dispatches the resulting events
+    TErrorCode Service( ) NOEXCEPT;
+
+    // Flags currently asserted as tracked by the engine (status flag bits of CMaskEnable)
+    inline CIina3221::CMaskEnable
+    State( ) const NOEXCEPT
+    {
+        return CIina3221::CMaskEnable{ iActiveFlags };
+    }
+
+    inline CIina3221::CMaskEnable
+    LastMaskEnable( ) const NOEXCEPT
+    {
+        return iLastMaskEnable;
+    }
+
+    // True once per conversion seen by Service, then cleared
+    bool ConsumeConversionReady( ) NOEXCEPT;
+
+    // CIina3221::TConversionReadyCallback sharing the engine's mask/enable read, so that
+    // ReadSnapshotIfReady does not clear latched flags behind the engine's back:
+    //   device.SetConversionReadyCallback( &CIna3221AlertEngine::ConversionReady, &engine );
+    static bool ConversionReady( void* aContext ) NOEXCEPT;
+
+private:
+    struct CHandler
+    {
+        TEventHandler iHandler = nullptr;
+        void* iContext = nullptr;
+        std::uint8_t iEventMask = 0;
+    };
+
+    CIina3221& iDevice;
+    CHandler iHandlers[ KMaxHandlerNumber ];
+    std::atomic< bool > iAlertPending{ false };
+    std::uint16_t iActiveFlags = 0;
+    CIina3221::CMaskEnable iLastMaskEnable;
+    bool iConversionReady = false;
+
+    void Dispatch( const CEvent& aEvent ) const NOEXCEPT;
+};
+
+}  // namespace ExternalHardware
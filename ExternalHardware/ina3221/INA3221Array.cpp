@@ -0,0 +1,139 @@
+#include <ExternalHardware/ina3221/INA3221Array.hpp>
+
+namespace ExternalHardware
+{
+CIna3221Array::CIna3221Array( AbstractPlatform::IAbstractI2CBus& aI2CBus ) NOEXCEPT
+    : iDevices{ { aI2CBus, CIina3221::KDefaultAddress },
+                { aI2CBus, CIina3221::KVSAddress },
+                { aI2CBus, CIina3221::KSDAAddress },
+                { aI2CBus, CIina3221::KSCLAddress } }
+{
+}
+
+CIna3221Array::TErrorCode
+CIna3221Array::Init( const CIina3221::CConfig& aConfig,
+                     std::uint8_t aDeviceMask,
+                     CIina3221::InitMode aInitMode ) NOEXCEPT
+{
+    iPresentDeviceMask = 0;
+    iNextDevice = 0;
+    TErrorCode firstError = AbstractPlatform::KOk;
+
+    for ( std::uint8_t device = 0; device < KDeviceNumber; ++device )
+    {
+        auto& health = iSnapshot.iHealth[ device ];
+        health = CDeviceHealth{ };
+        if ( ( aDeviceMask & ( 1 << device ) ) == 0 )
+        {
+            continue;
+        }
+
+        const auto result = iDevices[ device ].Init( aConfig, aInitMode );
+        UpdateHealth( device, result );
+        if ( result == AbstractPlatform::KOk )
+        {
+            health.iPresent = true;
+            iPresentDeviceMask |= 1 << device;
+        }
+        else if ( firstError == AbstractPlatform::KOk )
+        {
+            firstError = result;
+        }
+    }
+
+    if ( iPresentDeviceMask == 0 )
+    {
+        return firstError != AbstractPlatform::KOk ? firstError : AbstractPlatform::KGenericError;
+    }
+    return AbstractPlatform::KOk;
+}
+
+std::uint8_t
+CIna3221Array::Probe( AbstractPlatform::IAbstractI2CBus& aI2CBus,
+                      std::uint8_t aDeviceMask ) NOEXCEPT
+{
+    std::uint8_t respondingMask = 0;
+    for ( std::uint8_t device = 0; device < KDeviceNumber; ++device )
+    {
+        if ( ( aDeviceMask & ( 1 << device ) ) == 0 )
+        {
+            continue;
+        }
+        const std::uint8_t address = CIina3221::KDefaultAddress + device;
+        if ( aI2CBus.Write( address, nullptr, 0, false ) == 0 )
+        {
+            respondingMask |= 1 << device;
+        }
+    }
+    return respondingMask;
+}
+
+CIna3221Array::TErrorCode
+CIna3221Array::Poll( ) NOEXCEPT
+{
+    if ( iPresentDeviceMask == 0 )
+    {
+        return AbstractPlatform::KGenericError;
+    }
+
+    while ( ( iPresentDeviceMask & ( 1 << iNextDevice ) ) == 0 )
+    {
+        iNextDevice = ( iNextDevice + 1 ) % KDeviceNumber;
+    }
+
+    const auto device = iNextDevice;
+    iNextDevice = ( iNextDevice + 1 ) % KDeviceNumber;
+
+    auto& snapshot = iSnapshot.iDevice[ device ];
+    const auto result = iDevices[ device ].ReadSnapshotIfReady( snapshot );
+    if ( result == AbstractPlatform::KOk && snapshot.iFresh )
+    {
+        ++iSnapshot.iHealth[ device ].iSampleCount;
+    }
+    return UpdateHealth( device, result );
+}
+
+CIna3221Array::TErrorCode
+CIna3221Array::ReadAll( ) NOEXCEPT
+{
+    TErrorCode firstError = AbstractPlatform::KOk;
+    for ( std::uint8_t device = 0; device < KDeviceNumber; ++device )
+    {
+        if ( ( iPresentDeviceMask & ( 1 << device ) ) == 0 )
+        {
+            continue;
+        }
+
+        auto& snapshot = iSnapshot.iDevice[ device ];
+        const auto result = UpdateHealth( device, iDevices[ device ].ReadSnapshot( snapshot ) );
+        snapshot.iFresh = result == AbstractPlatform::KOk;
+        if ( result == AbstractPlatform::KOk )
+        {
+            ++iSnapshot.iHealth[ device ].iSampleCount;
+        }
+        else if ( firstError == AbstractPlatform::KOk )
+        {
+            firstError = result;
+        }
+    }
+    return firstError;
+}
+
+CIna3221Array::TErrorCode
+CIna3221Array::UpdateHealth( std::uint8_t aDevice, TErrorCode aResult ) NOEXCEPT
+{
+    auto& health = iSnapshot.iHealth[ aDevice ];
+    health.iLastError = aResult;
+    if ( aResult == AbstractPlatform::KOk )
+    {
+        health.iConsecutiveErrors = 0;
+    }
+    else
+    {
+        ++health.iErrorCount;
+        ++health.iConsecutiveErrors;
+    }
+    return aResult;
+}
+
+}  // namespace ExternalHardware
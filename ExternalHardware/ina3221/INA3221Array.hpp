@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <AbstractPlatform/i2c/AbstractI2C.hpp>
+#include <ExternalHardware/ina3221/INA3221.hpp>
+
+namespace ExternalHardware
+{
+// Up to four INA3221 devices sharing one I2C bus, one per address slot (0x40..0x43)
+class CIna3221Array
+{
+public:
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    static constexpr std::uint8_t KDeviceNumber = 4;
+    static constexpr std::uint8_t KChannelNumber = KDeviceNumber * CIina3221::KChannelNumber;
+
+    // Address slots to probe, bit N selects address KDefaultAddress + N
+    static constexpr std::uint8_t KAllDevices = 0x0F;
+
+    struct CDeviceHealth
+    {
+        CDeviceHealth( ){ };
+
+        bool iPresent = false;  // Responded with a valid die ID during Init
+        TErrorCode iLastError = AbstractPlatform::KOk;
+        std::uint32_t iSampleCount = 0;        // Fresh snapshots read
+        std::uint32_t iErrorCount = 0;         // Failed operations in total
+        std::uint32_t iConsecutiveErrors = 0;  // Failed operations since the last success
+    };
+
+    struct CSnapshot
+    {
+        CSnapshot( ){ };
+
+        CIina3221::CMeasurementSnapshot iDevice[ KDeviceNumber ];
+        CDeviceHealth iHealth[ KDeviceNumber ];
+    };
+
+    CIna3221Array( AbstractPlatform::IAbstractI2CBus& aI2CBus ) NOEXCEPT;
+    ~CIna3221Array( ) = default;
+
+    // Probes and initializes the selected address slots. Succeeds if at least one device responds.
+    TErrorCode Init( const CIina3221::CConfig& aConfig = { },
+                     std::uint8_t aDeviceMask = KAllDevices,
+                     CIina3221::InitMode aInitMode = CIina3221::InitMode::Reset ) NOEXCEPT;
+
+    // Address slots of aDeviceMask whose address is acknowledged, one address-only write per slot
+    // (SMBus quick command, I2C addresses one target per transaction). No register pointer or
+    // register is touched, so drivers already using the devices are not disturbed: a read would
+    // clear CVRF and latched alert flags when the pointer is on mask/enable. The bus controller
+    // must support zero-length writes.
+    static std::uint8_t Probe( AbstractPlatform::IAbstractI2CBus& aI2CBus,
+                               std::uint8_t aDeviceMask = KAllDevices ) NOEXCEPT;
+
+    // Services the next present device in round-robin order, reading its measurement registers
+    // only if it has finished a new conversion. While one device is read the others keep
+    // converting, so calling Poll at DeviceNumber times the conversion rate keeps every device
+    // sampled without waiting on any of them.
+    TErrorCode Poll( ) NOEXCEPT;
+
+    // Reads a snapshot of every present device regardless of conversion state
+    TErrorCode ReadAll( ) NOEXCEPT;
+
+    inline const CSnapshot&
+    Snapshot( ) const NOEXCEPT
+    {
+        return iSnapshot;
+    }
+
+    inline std::uint8_t
+    PresentDeviceMask( ) const NOEXCEPT
+    {
+        return iPresentDeviceMask;
+    }
+
+    // aDevice is the address slot 0..KDeviceNumber-1
+    inline CIina3221&
+    Device( std::uint8_t aDevice ) NOEXCEPT
+    {
+        return iDevices[ aDevice ];
+    }
+
+private:
+    CIina3221 iDevices[ KDeviceNumber ];
+    CSnapshot iSnapshot;
+    std::uint8_t iPresentDeviceMask = 0;
+    std::uint8_t iNextDevice = 0;
+
+    TErrorCode UpdateHealth( std::uint8_t aDevice, TErrorCode aResult ) NOEXCEPT;
+};
+
+}  // namespace ExternalHardware
@@ -0,0 +1,260 @@
+#include <ExternalHardware/ina3221/INA3221Async.hpp>
+
+namespace ExternalHardware
+{
+namespace
+{
+using TRegisterMap = Ina3221::CRegisterMap;
+
+static constexpr std::uint8_t KRegConfig = TRegisterMap::TConfig::KAddress;
+static constexpr std::uint8_t KRegMaskEnable = TRegisterMap::TMaskEnable::KAddress;
+static constexpr std::uint8_t KRegMeasurementFirst = TRegisterMap::TShuntVoltage::KAddress;
+
+static constexpr std::uint16_t KMaskEnableCVRFBit = CIina3221::CMaskEnable::TCVRF::KMask;
+
+}  // namespace
+
+CIna3221Async::CIna3221Async( IAsyncI2CBus& aBus, std::uint8_t aDeviceAddress ) NOEXCEPT
+    : iBus{ aBus },
+      iDeviceAddress{ aDeviceAddress }
+{
+}
+
+CIna3221Async::TErrorCode
+CIna3221Async::StartReadSnapshot( CIina3221::CMeasurementSnapshot& aSnapshot,
+                                  TDone aDone,
+                                  void* aContext ) NOEXCEPT
+{
+    const auto result = Begin( State::ReadMeasurement, aDone, aContext );
+    if ( result != AbstractPlatform::KOk )
+    {
+        return result;
+    }
+    iSnapshot = &aSnapshot;
+    if ( !StartRead( KRegMeasurementFirst, KMeasurementRegisterNumber ) )
+    {
+        iState = State::Idle;
+        return AbstractPlatform::KGenericError;
+    }
+    return AbstractPlatform::KOk;
+}
+
+CIna3221Async::TErrorCode
+CIna3221Async::StartReadSnapshotIfReady( CIina3221::CMeasurementSnapshot& aSnapshot,
+                                         TDone aDone,
+                                         void* aContext ) NOEXCEPT
+{
+    const auto result = Begin( State::ReadMaskEnable, aDone, aContext );
+    if ( result != AbstractPlatform::KOk )
+    {
+        return result;
+    }
+    iSnapshot = &aSnapshot;
+    if ( !StartRead( KRegMaskEnable, 1 ) )
+    {
+        iState = State::Idle;
+        return AbstractPlatform::KGenericError;
+    }
+    return AbstractPlatform::KOk;
+}
+
+CIna3221Async::TErrorCode
+CIna3221Async::StartSetConfig( const CIina3221::CConfig& aConfig,
+                               TDone aDone,
+                               void* aContext ) NOEXCEPT
+{
+    return StartWriteRegister( KRegConfig, aConfig.Value( ), aDone, aContext );
+}
+
+CIna3221Async::TErrorCode
+CIna3221Async::StartSetMaskEnable( const CIina3221::CMaskEnable& aMaskEnable,
+                                   TDone aDone,
+                                   void* aContext ) NOEXCEPT
+{
+    return StartWriteRegister( KRegMaskEnable, aMaskEnable.Value( ), aDone, aContext );
+}
+
+CIna3221Async::TErrorCode
+CIna3221Async::StartReadRegister( std::uint8_t aRegisterAddress,
+                                  std::uint16_t& aRegisterValue,
+                                  TDone aDone,
+                                  void* aContext ) NOEXCEPT
+{
+    const auto result = Begin( State::ReadRegister, aDone, aContext );
+    if ( result != AbstractPlatform::KOk )
+    {
+        return result;
+    }
+    iRegisterValue = &aRegisterValue;
+    if ( !StartRead( aRegisterAddress, 1 ) )
+    {
+        iState = State::Idle;
+        return AbstractPlatform::KGenericError;
+    }
+    return AbstractPlatform::KOk;
+}
+
+CIna3221Async::TErrorCode
+CIna3221Async::StartWriteRegister( std::uint8_t aRegisterAddress,
+                                   std::uint16_t aRegisterValue,
+                                   TDone aDone,
+                                   void* aContext ) NOEXCEPT
+{
+    const auto result = Begin( State::WriteRegister, aDone, aContext );
+    if ( result != AbstractPlatform::KOk )
+    {
+        return result;
+    }
+    if ( !StartWrite( aRegisterAddress, aRegisterValue ) )
+    {
+        iState = State::Idle;
+        return AbstractPlatform::KGenericError;
+    }
+    return AbstractPlatform::KOk;
+}
+
+CIna3221Async::TErrorCode
+CIna3221Async::Begin( State aState, TDone aDone, void* aContext ) NOEXCEPT
+{
+    if ( iState != State::Idle )
+    {
+        return AbstractPlatform::KGenericError;
+    }
+    iState = aState;
+    iDone = aDone;
+    iDoneContext = aContext;
+    return AbstractPlatform::KOk;
+}
+
+bool
+CIna3221Async::StartRead( std::uint8_t aRegisterAddress, std::size_t aRegisterCount ) NOEXCEPT
+{
+    // Skip the pointer write when the device already points at the register
+    const bool pointerReuse = iLastRegisterValid && aRegisterAddress == iLastRegisterAddress;
+    iRegisterAddress = aRegisterAddress;
+    iWriteBuffer[ 0 ] = aRegisterAddress;
+    return iBus.StartTransfer( iDeviceAddress,
+                               iWriteBuffer,
+                               pointerReuse ? 0 : 1,
+                               iReadBuffer,
+                               2 * aRegisterCount,
+                               &CIna3221Async::OnTransferComplete,
+                               this );
+}
+
+bool
+CIna3221Async::StartWrite( std::uint8_t aRegisterAddress, std::uint16_t aRegisterValue ) NOEXCEPT
+{
+    iRegisterAddress = aRegisterAddress;
+    iWriteBuffer[ 0 ] = aRegisterAddress;
+    iWriteBuffer[ 1 ] = static_cast< std::uint8_t >( aRegisterValue >> 8 );
+    iWriteBuffer[ 2 ] = static_cast< std::uint8_t >( aRegisterValue );
+    return iBus.StartTransfer( iDeviceAddress,
+                               iWriteBuffer,
+                               sizeof( iWriteBuffer ),
+                               nullptr,
+                               0,
+                               &CIna3221Async::OnTransferComplete,
+                               this );
+}
+
+void
+CIna3221Async::OnTransferComplete( void* aContext, bool aSuccess ) NOEXCEPT
+{
+    static_cast< CIna3221Async* >( aContext )->Advance( aSuccess );
+}
+
+void
+CIna3221Async::Advance( bool aSuccess ) NOEXCEPT
+{
+    if ( !aSuccess )
+    {
+        // The pointer write may or may not have been acknowledged
+        iLastRegisterValid = false;
+        if ( iState == State::ReadFreshMeasurement )
+        {
+            iSnapshot->iFresh = false;
+        }
+        Finish( AbstractPlatform::KGenericError );
+        return;
+    }
+    iLastRegisterAddress = iRegisterAddress;
+    iLastRegisterValid = true;
+
+    switch ( iState )
+    {
+    case State::ReadRegister:
+        *iRegisterValue = ReadBufferRegister( 0 );
+        Finish( AbstractPlatform::KOk );
+        break;
+
+    case State::WriteRegister:
+        Finish( AbstractPlatform::KOk );
+        break;
+
+    case State::ReadMaskEnable:
+        if ( ( ReadBufferRegister( 0 ) & KMaskEnableCVRFBit ) == 0 )
+        {
+            iSnapshot->iFresh = false;
+            Finish( AbstractPlatform::KOk );
+        }
+        else
+        {
+            iState = State::ReadFreshMeasurement;
+            if ( !StartRead( KRegMeasurementFirst, KMeasurementRegisterNumber ) )
+            {
+                iSnapshot->iFresh = false;
+                Finish( AbstractPlatform::KGenericError );
+            }
+        }
+        break;
+
+    case State::ReadMeasurement:
+        DecodeSnapshot( );
+        Finish( AbstractPlatform::KOk );
+        break;
+
+    case State::ReadFreshMeasurement:
+        DecodeSnapshot( );
+        iSnapshot->iFresh = true;
+        Finish( AbstractPlatform::KOk );
+        break;
+
+    case State::Idle:
+        break;
+    }
+}
+
+void
+CIna3221Async::Finish( TErrorCode aResult ) NOEXCEPT
+{
+    // Idle before notifying, so the done callback can start the next operation
+    const auto done = iDone;
+    const auto context = iDoneContext;
+    iState = State::Idle;
+    iLastResult = aResult;
+    if ( done != nullptr )
+    {
+        done( context, aResult );
+    }
+}
+
+std::uint16_t
+CIna3221Async::ReadBufferRegister( std::size_t aIndex ) const NOEXCEPT
+{
+    return static_cast< std::uint16_t >( ( iReadBuffer[ 2 * aIndex ] << 8 )
+                                         | iReadBuffer[ 2 * aIndex + 1 ] );
+}
+
+void
+CIna3221Async::DecodeSnapshot( ) NOEXCEPT
+{
+    std::uint16_t registers[ KMeasurementRegisterNumber ];
+    for ( std::uint8_t i = 0; i < KMeasurementRegisterNumber; ++i )
+    {
+        registers[ i ] = ReadBufferRegister( i );
+    }
+    CIina3221::DecodeSnapshot( registers, *iSnapshot );
+}
+
+}  // namespace ExternalHardware
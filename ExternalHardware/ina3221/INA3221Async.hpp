@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <ExternalHardware/ina3221/INA3221.hpp>
+
+namespace ExternalHardware
+{
+// Asynchronous counterpart of IAbstractI2CBus for interrupt- or DMA-driven controllers.
+// StartTransfer writes aWriteSize bytes, then (repeated start) reads aReadSize bytes, either part
+// may be empty. Completion is reported through aCompletion, possibly from interrupt context or
+// from within StartTransfer. Implementations may queue transfers of different devices.
+class IAsyncI2CBus
+{
+public:
+    using TCompletion = void ( * )( void* aContext, bool aSuccess );
+
+    virtual ~IAsyncI2CBus( ) = default;
+
+    // Returns false if the transfer could not be started, aCompletion is not called then
+    virtual bool StartTransfer( std::uint8_t aAddress,
+                                const std::uint8_t* aWriteData,
+                                std::size_t aWriteSize,
+                                std::uint8_t* aReadData,
+                                std::size_t aReadSize,
+                                TCompletion aCompletion,
+                                void* aContext ) NOEXCEPT = 0;
+};
+
+// Non-blocking INA3221 access: each Start* call begins an operation and returns immediately, the
+// operation advances from the bus completion callbacks and finishes with aDone. One operation
+// per device can be in flight; a single core can keep many devices busy at once.
+//
+// The device keeps its own register pointer state, so do not mix it with a CIina3221 driving
+// the same chip. aDone runs in the context of the bus completion (possibly an interrupt).
+class CIna3221Async
+{
+public:
+    using TErrorCode = AbstractPlatform::TErrorCode;
+    using TDone = void ( * )( void* aContext, TErrorCode aResult );
+
+    CIna3221Async( IAsyncI2CBus& aBus,
+                   std::uint8_t aDeviceAddress = CIina3221::KDefaultAddress ) NOEXCEPT;
+
+    CIna3221Async( const CIna3221Async& ) = delete;
+    CIna3221Async& operator=( const CIna3221Async& ) = delete;
+
+    inline std::uint8_t
+    DeviceAddress( ) const NOEXCEPT
+    {
+        return iDeviceAddress;
+    }
+
+    // True while an operation is in flight
+    inline bool
+    IsBusy( ) const NOEXCEPT
+    {
+        return iState != State::Idle;
+    }
+
+    // Result of the last finished operation, for polling instead of a done callback
+    inline TErrorCode
+    LastResult( ) const NOEXCEPT
+    {
+        return iLastResult;
+    }
+
+    // All shunt/bus voltage registers in one block read, as CIina3221::ReadSnapshot
+    TErrorCode StartReadSnapshot( CIina3221::CMeasurementSnapshot& aSnapshot,
+                                  TDone aDone = nullptr,
+                                  void* aContext = nullptr ) NOEXCEPT;
+
+    // Mask/enable read, then the block read only if a new conversion completed, as
+    // CIina3221::ReadSnapshotIfReady
+    TErrorCode StartReadSnapshotIfReady( CIina3221::CMeasurementSnapshot& aSnapshot,
+                                         TDone aDone = nullptr,
+                                         void* aContext = nullptr ) NOEXCEPT;
+
+    TErrorCode StartSetConfig( const CIina3221::CConfig& aConfig,
+                               TDone aDone = nullptr,
+                               void* aContext = nullptr ) NOEXCEPT;
+
+    TErrorCode StartSetMaskEnable( const CIina3221::CMaskEnable& aMaskEnable,
+                                   TDone aDone = nullptr,
+                                   void* aContext = nullptr ) NOEXCEPT;
+
+    // Raw register access for the remaining registers (alert limits, IDs, ...)
+    TErrorCode StartReadRegister( std::uint8_t aRegisterAddress,
+                                  std::uint16_t& aRegisterValue,
+                                  TDone aDone = nullptr,
+                                  void* aContext = nullptr ) NOEXCEPT;
+
+    TErrorCode StartWriteRegister( std::uint8_t aRegisterAddress,
+                                   std::uint16_t aRegisterValue,
+                                   TDone aDone = nullptr,
+                                   void* aContext = nullptr ) NOEXCEPT;
+
+private:
+    enum class State : std::uint8_t
+    {
+        Idle,
+        ReadRegister,
+        WriteRegister,
+        ReadMaskEnable,        // ReadSnapshotIfReady, conversion-ready check
+        ReadMeasurement,       // ReadSnapshot
+        ReadFreshMeasurement,  // ReadSnapshotIfReady after a completed conversion
+    };
+
+    static constexpr std::uint8_t KMeasurementRegisterNumber
+        = CIina3221::KMeasurementRegisterNumber;
+
+    IAsyncI2CBus& iBus;
+    const std::uint8_t iDeviceAddress;
+    std::uint8_t iLastRegisterAddress = 0x00;
+    bool iLastRegisterValid = false;
+
+    State iState = State::Idle;
+    TErrorCode iLastResult = AbstractPlatform::KOk;
+    TDone iDone = nullptr;
+    void* iDoneContext = nullptr;
+
+    std::uint8_t iRegisterAddress = 0;
+    std::uint16_t* iRegisterValue = nullptr;
+    CIina3221::CMeasurementSnapshot* iSnapshot = nullptr;
+
+    std::uint8_t iWriteBuffer[ 3 ] = { };
+    std::uint8_t iReadBuffer[ 2 * KMeasurementRegisterNumber ] = { };
+
+    TErrorCode Begin( State aState, TDone aDone, void* aContext ) NOEXCEPT;
+    bool StartRead( std::uint8_t aRegisterAddress, std::size_t aRegisterCount ) NOEXCEPT;
+    bool StartWrite( std::uint8_t aRegisterAddress, std::uint16_t aRegisterValue ) NOEXCEPT;
+    void Advance( bool aSuccess ) NOEXCEPT;
+    void Finish( TErrorCode aResult ) NOEXCEPT;
+    std::uint16_t ReadBufferRegister( std::size_t aIndex ) const NOEXCEPT;
+    void DecodeSnapshot( ) NOEXCEPT;
+
+    static void OnTransferComplete( void* aContext, bool aSuccess ) NOEXCEPT;
+};
+
+}  // namespace ExternalHardware
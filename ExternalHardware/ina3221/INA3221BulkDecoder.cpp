@@ -0,0 +1,492 @@
+#include <ExternalHardware/ina3221/INA3221BulkDecoder.hpp>
+#include <AbstractPlatform/common/TypeBinaryRepresentation.hpp>
+
+#include <atomic>
+
+#if ( defined( __x86_64__ ) || defined( __i386__ ) ) && defined( __GNUC__ )
+#define INA3221_BULK_DECODER_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined( __aarch64__ ) && defined( __ARM_NEON ) \
+    && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define INA3221_BULK_DECODER_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace ExternalHardware
+{
+namespace
+{
+using TInstructionSet = CIna3221BulkDecoder::InstructionSet;
+using TRegisterKind = CIna3221BulkDecoder::RegisterKind;
+
+constexpr std::int16_t KShuntLsbUv = static_cast< std::int16_t >( CIina3221::KShuntVoltageLsbUv );
+constexpr std::int16_t KBusLsbUv = static_cast< std::int16_t >( CIina3221::KBusVoltageLsbUv );
+
+// The vector paths multiply 16-bit counts by 16-bit LSBs and shift out the 3 unused data bits
+static_assert( CIina3221::KShuntVoltageLsbUv == KShuntLsbUv, "" );
+static_assert( CIina3221::KBusVoltageLsbUv == KBusLsbUv, "" );
+
+constexpr bool
+IsShuntRegister( TRegisterKind aKind, std::size_t aIndex ) NOEXCEPT
+{
+    return aKind == TRegisterKind::ShuntVoltage
+           || ( aKind == TRegisterKind::MeasurementBlock && ( aIndex & 1 ) == 0 );
+}
+
+inline std::int16_t
+ScalarCounts( std::uint16_t aWireRegister ) NOEXCEPT
+{
+    using namespace AbstractPlatform;
+    return CIina3221::VoltageRegisterToCounts(
+        EndiannessConverter< Endianness::Native, Endianness::Big >::Convert( aWireRegister ) );
+}
+
+// Reference decode, also finishes the tails of the vector paths (aBegin is always even there,
+// so the shunt/bus alternation of measurement blocks stays aligned)
+void
+ScalarDecodeCounts( const std::uint16_t* aRegisters,
+                    std::size_t aBegin,
+                    std::size_t aEnd,
+                    std::int16_t* aCounts ) NOEXCEPT
+{
+    for ( std::size_t index = aBegin; index < aEnd; ++index )
+    {
+        aCounts[ index ] = ScalarCounts( aRegisters[ index ] );
+    }
+}
+
+void
+ScalarDecodeMicroVolts( const std::uint16_t* aRegisters,
+                        std::size_t aBegin,
+                        std::size_t aEnd,
+                        TRegisterKind aKind,
+                        std::int32_t* aMicroVolts ) NOEXCEPT
+{
+    using namespace AbstractPlatform;
+    for ( std::size_t index = aBegin; index < aEnd; ++index )
+    {
+        const auto registerValue
+            = EndiannessConverter< Endianness::Native, Endianness::Big >::Convert(
+                aRegisters[ index ] );
+        aMicroVolts[ index ] = IsShuntRegister( aKind, index )
+                                   ? CIina3221::ShuntRegisterToUv( registerValue )
+                                   : CIina3221::BusRegisterToUv( registerValue );
+    }
+}
+
+void
+ScalarDecodeVolts( const std::uint16_t* aRegisters,
+                   std::size_t aBegin,
+                   std::size_t aEnd,
+                   TRegisterKind aKind,
+                   float* aVolts ) NOEXCEPT
+{
+    using namespace AbstractPlatform;
+    for ( std::size_t index = aBegin; index < aEnd; ++index )
+    {
+        const auto registerValue
+            = EndiannessConverter< Endianness::Native, Endianness::Big >::Convert(
+                aRegisters[ index ] );
+        aVolts[ index ] = IsShuntRegister( aKind, index )
+                              ? CIina3221::ShuntRegisterToVolts( registerValue )
+                              : CIina3221::BusRegisterToVolts( registerValue );
+    }
+}
+
+#ifdef INA3221_BULK_DECODER_X86
+
+#define INA3221_TARGET_SSE2 __attribute__( ( target( "sse2" ) ) )
+#define INA3221_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+
+// Byte swap and arithmetic shift: the dropped low bits make masking unnecessary
+INA3221_TARGET_SSE2 inline __m128i
+Sse2Counts( const std::uint16_t* aRegisters ) NOEXCEPT
+{
+    const __m128i wire = _mm_loadu_si128( reinterpret_cast< const __m128i* >( aRegisters ) );
+    const __m128i value = _mm_or_si128( _mm_slli_epi16( wire, 8 ), _mm_srli_epi16( wire, 8 ) );
+    return _mm_srai_epi16( value, 3 );
+}
+
+INA3221_TARGET_SSE2 inline __m128i
+Sse2Lsb( TRegisterKind aKind ) NOEXCEPT
+{
+    return aKind == TRegisterKind::ShuntVoltage ? _mm_set1_epi16( KShuntLsbUv )
+           : aKind == TRegisterKind::BusVoltage
+               ? _mm_set1_epi16( KBusLsbUv )
+               : _mm_setr_epi16( KShuntLsbUv,
+                                 KBusLsbUv,
+                                 KShuntLsbUv,
+                                 KBusLsbUv,
+                                 KShuntLsbUv,
+                                 KBusLsbUv,
+                                 KShuntLsbUv,
+                                 KBusLsbUv );
+}
+
+// Microvolts of 8 registers: 16x16 to 32-bit products from the low and high halves
+INA3221_TARGET_SSE2 inline void
+Sse2MicroVolts( const std::uint16_t* aRegisters,
+                __m128i aLsb,
+                __m128i& aLow,
+                __m128i& aHigh ) NOEXCEPT
+{
+    const __m128i counts = Sse2Counts( aRegisters );
+    const __m128i low = _mm_mullo_epi16( counts, aLsb );
+    const __m128i high = _mm_mulhi_epi16( counts, aLsb );
+    aLow = _mm_unpacklo_epi16( low, high );
+    aHigh = _mm_unpackhi_epi16( low, high );
+}
+
+INA3221_TARGET_SSE2 void
+Sse2DecodeCounts( const std::uint16_t* aRegisters,
+                  std::size_t aCount,
+                  std::int16_t* aCounts ) NOEXCEPT
+{
+    std::size_t index = 0;
+    for ( ; index + 8 <= aCount; index += 8 )
+    {
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( aCounts + index ),
+                          Sse2Counts( aRegisters + index ) );
+    }
+    ScalarDecodeCounts( aRegisters, index, aCount, aCounts );
+}
+
+INA3221_TARGET_SSE2 void
+Sse2DecodeMicroVolts( const std::uint16_t* aRegisters,
+                      std::size_t aCount,
+                      TRegisterKind aKind,
+                      std::int32_t* aMicroVolts ) NOEXCEPT
+{
+    const __m128i lsb = Sse2Lsb( aKind );
+    std::size_t index = 0;
+    for ( ; index + 8 <= aCount; index += 8 )
+    {
+        __m128i low;
+        __m128i high;
+        Sse2MicroVolts( aRegisters + index, lsb, low, high );
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( aMicroVolts + index ), low );
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( aMicroVolts + index + 4 ), high );
+    }
+    ScalarDecodeMicroVolts( aRegisters, index, aCount, aKind, aMicroVolts );
+}
+
+INA3221_TARGET_SSE2 void
+Sse2DecodeVolts( const std::uint16_t* aRegisters,
+                 std::size_t aCount,
+                 TRegisterKind aKind,
+                 float* aVolts ) NOEXCEPT
+{
+    const __m128i lsb = Sse2Lsb( aKind );
+    const __m128 voltsPerMicroVolt = _mm_set1_ps( CIina3221::KVoltsPerMicroVolt );
+    std::size_t index = 0;
+    for ( ; index + 8 <= aCount; index += 8 )
+    {
+        __m128i low;
+        __m128i high;
+        Sse2MicroVolts( aRegisters + index, lsb, low, high );
+        _mm_storeu_ps( aVolts + index, _mm_mul_ps( _mm_cvtepi32_ps( low ), voltsPerMicroVolt ) );
+        _mm_storeu_ps( aVolts + index + 4,
+                       _mm_mul_ps( _mm_cvtepi32_ps( high ), voltsPerMicroVolt ) );
+    }
+    ScalarDecodeVolts( aRegisters, index, aCount, aKind, aVolts );
+}
+
+INA3221_TARGET_AVX2 inline __m256i
+Avx2Counts( const std::uint16_t* aRegisters ) NOEXCEPT
+{
+    const __m256i byteSwap
+        = _mm256_setr_epi8( 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                            1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 );
+    const __m256i wire = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( aRegisters ) );
+    return _mm256_srai_epi16( _mm256_shuffle_epi8( wire, byteSwap ), 3 );
+}
+
+INA3221_TARGET_AVX2 inline __m256i
+Avx2Lsb( TRegisterKind aKind ) NOEXCEPT
+{
+    return aKind == TRegisterKind::ShuntVoltage ? _mm256_set1_epi32( KShuntLsbUv )
+           : aKind == TRegisterKind::BusVoltage
+               ? _mm256_set1_epi32( KBusLsbUv )
+               : _mm256_setr_epi32( KShuntLsbUv,
+                                    KBusLsbUv,
+                                    KShuntLsbUv,
+                                    KBusLsbUv,
+                                    KShuntLsbUv,
+                                    KBusLsbUv,
+                                    KShuntLsbUv,
+                                    KBusLsbUv );
+}
+
+// Microvolts of 16 registers as two vectors of 8
+INA3221_TARGET_AVX2 inline void
+Avx2MicroVolts( const std::uint16_t* aRegisters,
+                __m256i aLsb,
+                __m256i& aLow,
+                __m256i& aHigh ) NOEXCEPT
+{
+    const __m256i counts = Avx2Counts( aRegisters );
+    const __m256i low = _mm256_cvtepi16_epi32( _mm256_castsi256_si128( counts ) );
+    const __m256i high = _mm256_cvtepi16_epi32( _mm256_extracti128_si256( counts, 1 ) );
+    aLow = _mm256_mullo_epi32( low, aLsb );
+    aHigh = _mm256_mullo_epi32( high, aLsb );
+}
+
+INA3221_TARGET_AVX2 void
+Avx2DecodeCounts( const std::uint16_t* aRegisters,
+                  std::size_t aCount,
+                  std::int16_t* aCounts ) NOEXCEPT
+{
+    std::size_t index = 0;
+    for ( ; index + 16 <= aCount; index += 16 )
+    {
+        _mm256_storeu_si256( reinterpret_cast< __m256i* >( aCounts + index ),
+                             Avx2Counts( aRegisters + index ) );
+    }
+    ScalarDecodeCounts( aRegisters, index, aCount, aCounts );
+}
+
+INA3221_TARGET_AVX2 void
+Avx2DecodeMicroVolts( const std::uint16_t* aRegisters,
+                      std::size_t aCount,
+                      TRegisterKind aKind,
+                      std::int32_t* aMicroVolts ) NOEXCEPT
+{
+    const __m256i lsb = Avx2Lsb( aKind );
+    std::size_t index = 0;
+    for ( ; index + 16 <= aCount; index += 16 )
+    {
+        __m256i low;
+        __m256i high;
+        Avx2MicroVolts( aRegisters + index, lsb, low, high );
+        _mm256_storeu_si256( reinterpret_cast< __m256i* >( aMicroVolts + index ), low );
+        _mm256_storeu_si256( reinterpret_cast< __m256i* >( aMicroVolts + index + 8 ), high );
+    }
+    ScalarDecodeMicroVolts( aRegisters, index, aCount, aKind, aMicroVolts );
+}
+
+INA3221_TARGET_AVX2 void
+Avx2DecodeVolts( const std::uint16_t* aRegisters,
+                 std::size_t aCount,
+                 TRegisterKind aKind,
+                 float* aVolts ) NOEXCEPT
+{
+    const __m256i lsb = Avx2Lsb( aKind );
+    const __m256 voltsPerMicroVolt = _mm256_set1_ps( CIina3221::KVoltsPerMicroVolt );
+    std::size_t index = 0;
+    for ( ; index + 16 <= aCount; index += 16 )
+    {
+        __m256i low;
+        __m256i high;
+        Avx2MicroVolts( aRegisters + index, lsb, low, high );
+        _mm256_storeu_ps( aVolts + index,
+                          _mm256_mul_ps( _mm256_cvtepi32_ps( low ), voltsPerMicroVolt ) );
+        _mm256_storeu_ps( aVolts + index + 8,
+                          _mm256_mul_ps( _mm256_cvtepi32_ps( high ), voltsPerMicroVolt ) );
+    }
+    ScalarDecodeVolts( aRegisters, index, aCount, aKind, aVolts );
+}
+
+#endif  // INA3221_BULK_DECODER_X86
+
+#ifdef INA3221_BULK_DECODER_NEON
+
+inline int16x8_t
+NeonCounts( const std::uint16_t* aRegisters ) NOEXCEPT
+{
+    const uint8x16_t wire = vreinterpretq_u8_u16( vld1q_u16( aRegisters ) );
+    return vshrq_n_s16( vreinterpretq_s16_u8( vrev16q_u8( wire ) ), 3 );
+}
+
+inline int16x8_t
+NeonLsb( TRegisterKind aKind ) NOEXCEPT
+{
+    const std::int16_t alternating[ 8 ] = { KShuntLsbUv, KBusLsbUv, KShuntLsbUv, KBusLsbUv,
+                                            KShuntLsbUv, KBusLsbUv, KShuntLsbUv, KBusLsbUv };
+    return aKind == TRegisterKind::ShuntVoltage ? vdupq_n_s16( KShuntLsbUv )
+           : aKind == TRegisterKind::BusVoltage ? vdupq_n_s16( KBusLsbUv )
+                                                : vld1q_s16( alternating );
+}
+
+void
+NeonDecodeCounts( const std::uint16_t* aRegisters,
+                  std::size_t aCount,
+                  std::int16_t* aCounts ) NOEXCEPT
+{
+    std::size_t index = 0;
+    for ( ; index + 8 <= aCount; index += 8 )
+    {
+        vst1q_s16( aCounts + index, NeonCounts( aRegisters + index ) );
+    }
+    ScalarDecodeCounts( aRegisters, index, aCount, aCounts );
+}
+
+void
+NeonDecodeMicroVolts( const std::uint16_t* aRegisters,
+                      std::size_t aCount,
+                      TRegisterKind aKind,
+                      std::int32_t* aMicroVolts ) NOEXCEPT
+{
+    const int16x8_t lsb = NeonLsb( aKind );
+    std::size_t index = 0;
+    for ( ; index + 8 <= aCount; index += 8 )
+    {
+        const int16x8_t counts = NeonCounts( aRegisters + index );
+        vst1q_s32( aMicroVolts + index, vmull_s16( vget_low_s16( counts ), vget_low_s16( lsb ) ) );
+        vst1q_s32( aMicroVolts + index + 4, vmull_high_s16( counts, lsb ) );
+    }
+    ScalarDecodeMicroVolts( aRegisters, index, aCount, aKind, aMicroVolts );
+}
+
+void
+NeonDecodeVolts( const std::uint16_t* aRegisters,
+                 std::size_t aCount,
+                 TRegisterKind aKind,
+                 float* aVolts ) NOEXCEPT
+{
+    const int16x8_t lsb = NeonLsb( aKind );
+    const float32x4_t voltsPerMicroVolt = vdupq_n_f32( CIina3221::KVoltsPerMicroVolt );
+    std::size_t index = 0;
+    for ( ; index + 8 <= aCount; index += 8 )
+    {
+        const int16x8_t counts = NeonCounts( aRegisters + index );
+        const int32x4_t low = vmull_s16( vget_low_s16( counts ), vget_low_s16( lsb ) );
+        const int32x4_t high = vmull_high_s16( counts, lsb );
+        vst1q_f32( aVolts + index, vmulq_f32( vcvtq_f32_s32( low ), voltsPerMicroVolt ) );
+        vst1q_f32( aVolts + index + 4, vmulq_f32( vcvtq_f32_s32( high ), voltsPerMicroVolt ) );
+    }
+    ScalarDecodeVolts( aRegisters, index, aCount, aKind, aVolts );
+}
+
+#endif  // INA3221_BULK_DECODER_NEON
+
+TInstructionSet
+DetectInstructionSet( ) NOEXCEPT
+{
+    const TInstructionSet candidates[]
+        = { TInstructionSet::Avx2, TInstructionSet::Neon, TInstructionSet::Sse2 };
+    for ( const auto candidate : candidates )
+    {
+        if ( CIna3221BulkDecoder::IsSupported( candidate ) )
+        {
+            return candidate;
+        }
+    }
+    return TInstructionSet::Scalar;
+}
+
+std::atomic< TInstructionSet >&
+ActiveInstructionSetSlot( ) NOEXCEPT
+{
+    static std::atomic< TInstructionSet > instructionSet{ DetectInstructionSet( ) };
+    return instructionSet;
+}
+
+}  // namespace
+
+bool
+CIna3221BulkDecoder::IsSupported( InstructionSet aInstructionSet ) NOEXCEPT
+{
+    switch ( aInstructionSet )
+    {
+    case InstructionSet::Scalar:
+        return true;
+#ifdef INA3221_BULK_DECODER_X86
+    case InstructionSet::Sse2:
+        return __builtin_cpu_supports( "sse2" );
+    case InstructionSet::Avx2:
+        return __builtin_cpu_supports( "avx2" );
+#endif
+#ifdef INA3221_BULK_DECODER_NEON
+    case InstructionSet::Neon:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+CIna3221BulkDecoder::InstructionSet
+CIna3221BulkDecoder::ActiveInstructionSet( ) NOEXCEPT
+{
+    return ActiveInstructionSetSlot( ).load( std::memory_order_relaxed );
+}
+
+CIna3221BulkDecoder::InstructionSet
+CIna3221BulkDecoder::SelectInstructionSet( InstructionSet aInstructionSet ) NOEXCEPT
+{
+    const auto selected = IsSupported( aInstructionSet ) ? aInstructionSet : InstructionSet::Scalar;
+    ActiveInstructionSetSlot( ).store( selected, std::memory_order_relaxed );
+    return selected;
+}
+
+void
+CIna3221BulkDecoder::DecodeCounts( const std::uint16_t* aRegisters,
+                                   std::size_t aCount,
+                                   std::int16_t* aCounts ) NOEXCEPT
+{
+    switch ( ActiveInstructionSet( ) )
+    {
+#ifdef INA3221_BULK_DECODER_X86
+    case InstructionSet::Avx2:
+        return Avx2DecodeCounts( aRegisters, aCount, aCounts );
+    case InstructionSet::Sse2:
+        return Sse2DecodeCounts( aRegisters, aCount, aCounts );
+#endif
+#ifdef INA3221_BULK_DECODER_NEON
+    case InstructionSet::Neon:
+        return NeonDecodeCounts( aRegisters, aCount, aCounts );
+#endif
+    default:
+        return ScalarDecodeCounts( aRegisters, 0, aCount, aCounts );
+    }
+}
+
+void
+CIna3221BulkDecoder::DecodeMicroVolts( const std::uint16_t* aRegisters,
+                                       std::size_t aCount,
+                                       RegisterKind aKind,
+                                       std::int32_t* aMicroVolts ) NOEXCEPT
+{
+    switch ( ActiveInstructionSet( ) )
+    {
+#ifdef INA3221_BULK_DECODER_X86
+    case InstructionSet::Avx2:
+        return Avx2DecodeMicroVolts( aRegisters, aCount, aKind, aMicroVolts );
+    case InstructionSet::Sse2:
+        return Sse2DecodeMicroVolts( aRegisters, aCount, aKind, aMicroVolts );
+#endif
+#ifdef INA3221_BULK_DECODER_NEON
+    case InstructionSet::Neon:
+        return NeonDecodeMicroVolts( aRegisters, aCount, aKind, aMicroVolts );
+#endif
+    default:
+        return ScalarDecodeMicroVolts( aRegisters, 0, aCount, aKind, aMicroVolts );
+    }
+}
+
+void
+CIna3221BulkDecoder::DecodeVolts( const std::uint16_t* aRegisters,
+                                  std::size_t aCount,
+                                  RegisterKind aKind,
+                                  float* aVolts ) NOEXCEPT
+{
+    switch ( ActiveInstructionSet( ) )
+    {
+#ifdef INA3221_BULK_DECODER_X86
+    case InstructionSet::Avx2:
+        return Avx2DecodeVolts( aRegisters, aCount, aKind, aVolts );
+    case InstructionSet::Sse2:
+        return Sse2DecodeVolts( aRegisters, aCount, aKind, aVolts );
+#endif
+#ifdef INA3221_BULK_DECODER_NEON
+    case InstructionSet::Neon:
+        return NeonDecodeVolts( aRegisters, aCount, aKind, aVolts );
+#endif
+    default:
+        return ScalarDecodeVolts( aRegisters, 0, aCount, aKind, aVolts );
+    }
+}
+
+}  // namespace ExternalHardware
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <AbstractPlatform/common/Platform.hpp>
+#include <ExternalHardware/ina3221/INA3221.hpp>
+
+namespace ExternalHardware
+{
+// Decodes buffers of raw shunt/bus voltage register words as they come off the bus (big-endian
+// byte order), e.g. logged block reads. Uses SSE2/AVX2 on x86 and NEON on AArch64 when available,
+// results match the scalar CIina3221 decode bit for bit.
+class CIna3221BulkDecoder
+{
+public:
+    enum class RegisterKind : std::uint8_t
+    {
+        ShuntVoltage,      // Shunt voltage registers of any channel
+        BusVoltage,        // Bus voltage registers of any channel
+        MeasurementBlock,  // Registers 0x01..0x06 in address order, shunt and bus alternate
+    };
+
+    enum class InstructionSet : std::uint8_t
+    {
+        Scalar,
+        Sse2,
+        Avx2,
+        Neon,
+    };
+
+    static bool IsSupported( InstructionSet aInstructionSet ) NOEXCEPT;
+
+    // Best supported instruction set unless overridden by SelectInstructionSet
+    static InstructionSet ActiveInstructionSet( ) NOEXCEPT;
+
+    // Overrides the dispatch (benchmarks, cross-checks), unsupported sets select Scalar.
+    // Returns the selected instruction set.
+    static InstructionSet SelectInstructionSet( InstructionSet aInstructionSet ) NOEXCEPT;
+
+    // Signed register counts, as CIina3221::VoltageRegisterToCounts
+    static void DecodeCounts( const std::uint16_t* aRegisters,
+                              std::size_t aCount,
+                              std::int16_t* aCounts ) NOEXCEPT;
+
+    // As CIina3221::ShuntRegisterToUv / BusRegisterToUv
+    static void DecodeMicroVolts( const std::uint16_t* aRegisters,
+                                  std::size_t aCount,
+                                  RegisterKind aKind,
+                                  std::int32_t* aMicroVolts ) NOEXCEPT;
+
+    // As CIina3221::ShuntRegisterToVolts / BusRegisterToVolts
+    static void DecodeVolts( const std::uint16_t* aRegisters,
+                             std::size_t aCount,
+                             RegisterKind aKind,
+                             float* aVolts ) NOEXCEPT;
+};
+
+}  // namespace ExternalHardware
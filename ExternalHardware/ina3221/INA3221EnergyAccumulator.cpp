@@ -0,0 +1,213 @@
+#include <ExternalHardware/ina3221/INA3221EnergyAccumulator.hpp>
+
+namespace ExternalHardware
+{
+namespace
+{
+constexpr std::uint8_t KLowWordBits = 32;
+constexpr std::uint64_t KLowWordMask = ( std::uint64_t{ 1 } << KLowWordBits ) - 1;
+
+// Trapezoid sums carry a factor of 2 and time in ns
+constexpr double KTrapezoidScale = 0.5 * 1e-9;
+constexpr double KChargeScale = KTrapezoidScale * CIina3221::KShuntVoltageLsbUv;
+constexpr double KEnergyScale
+    = KTrapezoidScale * CIina3221::KShuntVoltageLsbUv * CIina3221::KBusVoltageLsbUv * 1e-6;
+
+inline double
+WideValue( std::int64_t aHigh, std::int64_t aLow ) NOEXCEPT
+{
+    constexpr double KHighWordWeight = static_cast< double >( std::uint64_t{ 1 } << KLowWordBits );
+    return static_cast< double >( aHigh ) * KHighWordWeight + static_cast< double >( aLow );
+}
+
+}  // namespace
+
+void
+CIna3221EnergyAccumulator::CWideAccumulator::Add( std::int64_t aValue,
+                                                  std::uint64_t aDurationNs ) NOEXCEPT
+{
+    // aValue * aDurationNs split on the 32-bit boundary of the duration; |aValue| < 2^26
+    iHigh += aValue * static_cast< std::int64_t >( aDurationNs >> KLowWordBits );
+    iLow += aValue * static_cast< std::int64_t >( aDurationNs & KLowWordMask );
+
+    // Carry whole 2^32 units into the high word (floor division keeps iLow non-negative)
+    const auto carry = iLow >= 0 ? iLow >> KLowWordBits
+                                 : -( ( -iLow + KLowWordMask ) >> KLowWordBits );
+    iHigh += carry;
+    iLow -= carry * static_cast< std::int64_t >( std::uint64_t{ 1 } << KLowWordBits );
+}
+
+CIna3221EnergyAccumulator::CIna3221EnergyAccumulator( std::uint64_t aGapThresholdNs ) NOEXCEPT
+    : iGapThresholdNs{ aGapThresholdNs }
+{
+    for ( auto& word : iPublished )
+    {
+        word.store( 0, std::memory_order_relaxed );
+    }
+}
+
+CIna3221EnergyAccumulator::TErrorCode
+CIna3221EnergyAccumulator::SetShuntResistanceUOhm( std::uint32_t aMicroOhms,
+                                                   std::uint8_t aChannel ) NOEXCEPT
+{
+    if ( aChannel < CIina3221::KChannel1 || aChannel > KChannelNumber )
+    {
+        return AbstractPlatform::KInvalidArgumentError;
+    }
+    iShuntResistanceUOhm[ aChannel - CIina3221::KChannel1 ] = aMicroOhms;
+    return AbstractPlatform::KOk;
+}
+
+void
+CIna3221EnergyAccumulator::Add(
+    std::uint64_t aTimestampNs,
+    const std::uint16_t ( &aShuntVoltageRegisters )[ KChannelNumber ],
+    const std::uint16_t ( &aBusVoltageRegisters )[ KChannelNumber ] ) NOEXCEPT
+{
+    const auto resetRequests = iResetRequests.load( std::memory_order_acquire );
+    if ( resetRequests != iAppliedResetRequests )
+    {
+        iAppliedResetRequests = resetRequests;
+        const auto resetCount = iState.iResetCount + 1;
+        iState = CState{ };
+        iState.iResetCount = resetCount;
+    }
+
+    if ( iHasPrevious && aTimestampNs <= iPreviousTimestampNs )
+    {
+        ++iState.iRejectedCount;
+        Publish( );
+        return;
+    }
+
+    std::int32_t shunt[ KChannelNumber ];
+    std::int32_t power[ KChannelNumber ];
+    for ( std::uint8_t channel = 0; channel < KChannelNumber; ++channel )
+    {
+        shunt[ channel ] = CIina3221::VoltageRegisterToCounts( aShuntVoltageRegisters[ channel ] );
+        power[ channel ] = shunt[ channel ]
+                           * CIina3221::VoltageRegisterToCounts( aBusVoltageRegisters[ channel ] );
+    }
+
+    if ( iHasPrevious )
+    {
+        const auto durationNs = aTimestampNs - iPreviousTimestampNs;
+        if ( durationNs > iGapThresholdNs )
+        {
+            ++iState.iGapCount;
+            iState.iGapDurationNs += durationNs;
+        }
+
+        for ( std::uint8_t channel = 0; channel < KChannelNumber; ++channel )
+        {
+            iState.iCharge[ channel ].Add( iPreviousShunt[ channel ] + shunt[ channel ],
+                                           durationNs );
+            iState.iEnergy[ channel ].Add( iPreviousPower[ channel ] + power[ channel ],
+                                           durationNs );
+        }
+        iState.iDurationNs += durationNs;
+    }
+
+    ++iState.iSampleCount;
+    iHasPrevious = true;
+    iPreviousTimestampNs = aTimestampNs;
+    for ( std::uint8_t channel = 0; channel < KChannelNumber; ++channel )
+    {
+        iPreviousShunt[ channel ] = shunt[ channel ];
+        iPreviousPower[ channel ] = power[ channel ];
+    }
+
+    Publish( );
+}
+
+void
+CIna3221EnergyAccumulator::Publish( ) NOEXCEPT
+{
+    const auto sequence = iSequence.load( std::memory_order_relaxed );
+    iSequence.store( sequence + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    std::uint8_t word = 0;
+    for ( std::uint8_t channel = 0; channel < KChannelNumber; ++channel )
+    {
+        const auto& charge = iState.iCharge[ channel ];
+        const auto& energy = iState.iEnergy[ channel ];
+        iPublished[ word++ ].store( charge.iHigh, std::memory_order_relaxed );
+        iPublished[ word++ ].store( charge.iLow, std::memory_order_relaxed );
+        iPublished[ word++ ].store( energy.iHigh, std::memory_order_relaxed );
+        iPublished[ word++ ].store( energy.iLow, std::memory_order_relaxed );
+    }
+    iPublished[ word++ ].store( iState.iDurationNs, std::memory_order_relaxed );
+    iPublished[ word++ ].store( iState.iSampleCount, std::memory_order_relaxed );
+    iPublished[ word++ ].store( iState.iGapCount, std::memory_order_relaxed );
+    iPublished[ word++ ].store( iState.iGapDurationNs, std::memory_order_relaxed );
+    iPublished[ word++ ].store( iState.iRejectedCount, std::memory_order_relaxed );
+    iPublished[ word++ ].store( iState.iResetCount, std::memory_order_relaxed );
+
+    iSequence.store( sequence + 2, std::memory_order_release );
+}
+
+void
+CIna3221EnergyAccumulator::Snapshot( CRawSnapshot& aSnapshot ) const NOEXCEPT
+{
+    std::uint32_t sequence = 0;
+    do
+    {
+        sequence = iSequence.load( std::memory_order_acquire );
+        if ( sequence & 1 )
+        {
+            // Publication in progress
+            continue;
+        }
+
+        std::uint8_t word = 0;
+        for ( std::uint8_t channel = 0; channel < KChannelNumber; ++channel )
+        {
+            aSnapshot.iChargeHigh[ channel ]
+                = iPublished[ word++ ].load( std::memory_order_relaxed );
+            aSnapshot.iChargeLow[ channel ]
+                = iPublished[ word++ ].load( std::memory_order_relaxed );
+            aSnapshot.iEnergyHigh[ channel ]
+                = iPublished[ word++ ].load( std::memory_order_relaxed );
+            aSnapshot.iEnergyLow[ channel ]
+                = iPublished[ word++ ].load( std::memory_order_relaxed );
+        }
+        aSnapshot.iDurationNs = iPublished[ word++ ].load( std::memory_order_relaxed );
+        aSnapshot.iSampleCount = iPublished[ word++ ].load( std::memory_order_relaxed );
+        aSnapshot.iGapCount = iPublished[ word++ ].load( std::memory_order_relaxed );
+        aSnapshot.iGapDurationNs = iPublished[ word++ ].load( std::memory_order_relaxed );
+        aSnapshot.iRejectedCount = iPublished[ word++ ].load( std::memory_order_relaxed );
+        aSnapshot.iResetCount = iPublished[ word++ ].load( std::memory_order_relaxed );
+
+        std::atomic_thread_fence( std::memory_order_acquire );
+    } while ( ( sequence & 1 ) || sequence != iSequence.load( std::memory_order_relaxed ) );
+}
+
+void
+CIna3221EnergyAccumulator::Snapshot( CSnapshot& aSnapshot ) const NOEXCEPT
+{
+    CRawSnapshot raw;
+    Snapshot( raw );
+
+    for ( std::uint8_t channel = 0; channel < KChannelNumber; ++channel )
+    {
+        const auto shuntResistanceUOhm = iShuntResistanceUOhm[ channel ];
+        // µV / µΩ = A
+        const double conductance
+            = shuntResistanceUOhm != 0 ? 1.0 / static_cast< double >( shuntResistanceUOhm ) : 0.0;
+        aSnapshot.iChargeC[ channel ]
+            = WideValue( raw.iChargeHigh[ channel ], raw.iChargeLow[ channel ] ) * KChargeScale
+              * conductance;
+        aSnapshot.iEnergyJ[ channel ]
+            = WideValue( raw.iEnergyHigh[ channel ], raw.iEnergyLow[ channel ] ) * KEnergyScale
+              * conductance;
+    }
+    aSnapshot.iDurationNs = raw.iDurationNs;
+    aSnapshot.iSampleCount = raw.iSampleCount;
+    aSnapshot.iGapCount = raw.iGapCount;
+    aSnapshot.iGapDurationNs = raw.iGapDurationNs;
+    aSnapshot.iRejectedCount = raw.iRejectedCount;
+    aSnapshot.iResetCount = raw.iResetCount;
+}
+
+}  // namespace ExternalHardware
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <ExternalHardware/ina3221/INA3221.hpp>
+
+namespace ExternalHardware
+{
+// Per-channel charge and energy integration of raw shunt/bus register samples.
+// Add() is called by a single acquisition thread, Snapshot() and Reset() from any thread.
+class CIna3221EnergyAccumulator
+{
+public:
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    static constexpr std::uint8_t KChannelNumber = CIina3221::KChannelNumber;
+
+    // Integrals in register units: sum of ( value[ n - 1 ] + value[ n ] ) * dt[ns], where value is
+    // shunt counts for charge and shunt counts * bus counts for energy
+    struct CRawSnapshot
+    {
+        CRawSnapshot( ){ };
+
+        std::int64_t iChargeHigh[ KChannelNumber ] = { };  // Integral = High * 2^32 + Low
+        std::int64_t iChargeLow[ KChannelNumber ] = { };
+        std::int64_t iEnergyHigh[ KChannelNumber ] = { };
+        std::int64_t iEnergyLow[ KChannelNumber ] = { };
+
+        std::uint64_t iDurationNs = 0;  // Integrated time
+        std::uint64_t iSampleCount = 0;
+        std::uint64_t iGapCount = 0;    // Intervals longer than the gap threshold
+        std::uint64_t iGapDurationNs = 0;
+        std::uint64_t iRejectedCount = 0;  // Samples with non-increasing timestamps
+        std::uint64_t iResetCount = 0;
+    };
+
+    struct CSnapshot
+    {
+        CSnapshot( ){ };
+
+        double iChargeC[ KChannelNumber ] = { };
+        double iEnergyJ[ KChannelNumber ] = { };
+
+        std::uint64_t iDurationNs = 0;
+        std::uint64_t iSampleCount = 0;
+        std::uint64_t iGapCount = 0;
+        std::uint64_t iGapDurationNs = 0;
+        std::uint64_t iRejectedCount = 0;
+        std::uint64_t iResetCount = 0;
+    };
+
+    // Intervals longer than aGapThresholdNs (missed conversions) are still integrated by linear
+    // interpolation between the surrounding samples but are reported in the gap counters
+    explicit CIna3221EnergyAccumulator( std::uint64_t aGapThresholdNs = 1000000000 ) NOEXCEPT;
+
+    // Required for the physical units of CSnapshot, 0 leaves the channel charge/energy at 0
+    TErrorCode SetShuntResistanceUOhm( std::uint32_t aMicroOhms,
+                                       std::uint8_t aChannel = CIina3221::KChannel1 ) NOEXCEPT;
+
+    // Producer side: one sample of raw register words of all channels
+    void Add( std::uint64_t aTimestampNs,
+              const std::uint16_t ( &aShuntVoltageRegisters )[ KChannelNumber ],
+              const std::uint16_t ( &aBusVoltageRegisters )[ KChannelNumber ] ) NOEXCEPT;
+
+    inline void
+    Add( std::uint64_t aTimestampNs, const CIina3221::CMeasurementSnapshot& aSnapshot ) NOEXCEPT
+    {
+        Add( aTimestampNs, aSnapshot.iShuntVoltageRegister, aSnapshot.iBusVoltageRegister );
+    }
+
+    // Consistent copy of all accumulators, never blocks the producer
+    void Snapshot( CRawSnapshot& aSnapshot ) const NOEXCEPT;
+
+    void Snapshot( CSnapshot& aSnapshot ) const NOEXCEPT;
+
+    // Zeroes all accumulators. Applied by the producer together with the next sample, so each
+    // interval is attributed to exactly one side of the reset.
+    inline void
+    Reset( ) NOEXCEPT
+    {
+        iResetRequests.fetch_add( 1, std::memory_order_release );
+    }
+
+private:
+    // Two-word signed integral that cannot overflow within the lifetime of a deployment
+    struct CWideAccumulator
+    {
+        std::int64_t iHigh = 0;
+        std::int64_t iLow = 0;
+
+        void Add( std::int64_t aValue, std::uint64_t aDurationNs ) NOEXCEPT;
+    };
+
+    struct CState
+    {
+        CWideAccumulator iCharge[ KChannelNumber ];
+        CWideAccumulator iEnergy[ KChannelNumber ];
+        std::uint64_t iDurationNs = 0;
+        std::uint64_t iSampleCount = 0;
+        std::uint64_t iGapCount = 0;
+        std::uint64_t iGapDurationNs = 0;
+        std::uint64_t iRejectedCount = 0;
+        std::uint64_t iResetCount = 0;
+    };
+
+    static constexpr std::uint8_t KPublishedWordNumber = 4 * KChannelNumber + 6;
+
+    const std::uint64_t iGapThresholdNs;
+    std::uint32_t iShuntResistanceUOhm[ KChannelNumber ] = { };
+
+    // Producer-private state
+    CState iState;
+    bool iHasPrevious = false;
+    std::uint64_t iPreviousTimestampNs = 0;
+    std::int32_t iPreviousShunt[ KChannelNumber ] = { };
+    std::int32_t iPreviousPower[ KChannelNumber ] = { };
+    std::uint32_t iAppliedResetRequests = 0;
+
+    // Sequence lock protected copy of iState for the readers
+    std::atomic< std::uint32_t > iSequence{ 0 };
+    std::atomic< std::uint64_t > iPublished[ KPublishedWordNumber ];
+    std::atomic< std::uint32_t > iResetRequests{ 0 };
+
+    void Publish( ) NOEXCEPT;
+};
+
+}  // namespace ExternalHardware
@@ -0,0 +1,439 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <AbstractPlatform/common/Platform.hpp>
+#include <ExternalHardware/ina3221/INA3221.hpp>
+
+namespace ExternalHardware
+{
+// Integer filter stages for raw shunt/bus voltage counts. Values are register counts in fixed
+// point with KFractionBits fractional bits, so averaging stages keep the resolution they gain.
+// Every stage has
+//   bool Push( std::int32_t aInput, std::int32_t& aOutput )
+// returning true when it produced an output (decimators once per taFactor inputs), and Reset.
+// All state has a compile-time size.
+namespace Ina3221Filter
+{
+static constexpr std::uint8_t KFractionBits = 8;
+
+inline std::int32_t
+FromRegister( std::uint16_t aVoltageRegister ) NOEXCEPT
+{
+    return std::int32_t{ CIina3221::VoltageRegisterToCounts( aVoltageRegister ) }
+           * ( 1 << KFractionBits );
+}
+
+// aLsbUv: CIina3221::KShuntVoltageLsbUv or CIina3221::KBusVoltageLsbUv
+inline std::int32_t
+ToMicroVolts( std::int32_t aValue, std::int32_t aLsbUv ) NOEXCEPT
+{
+    constexpr std::int64_t KHalf = std::int64_t{ 1 } << ( KFractionBits - 1 );
+    return static_cast< std::int32_t >( ( std::int64_t{ aValue } * aLsbUv + KHalf )
+                                        >> KFractionBits );
+}
+
+inline std::int64_t
+RoundedDivide( std::int64_t aNumerator, std::int64_t aDenominator ) NOEXCEPT
+{
+    return ( aNumerator < 0 ? aNumerator - aDenominator / 2 : aNumerator + aDenominator / 2 )
+           / aDenominator;
+}
+
+constexpr std::int64_t
+Power( std::uint32_t aBase, std::uint8_t aExponent ) NOEXCEPT
+{
+    return aExponent == 0 ? 1 : aBase * Power( aBase, aExponent - 1 );
+}
+
+// Mean of each block of taFactor inputs (sum and dump)
+template < std::uint32_t taFactor >
+class CBoxcarDecimator
+{
+public:
+    static_assert( taFactor > 0, "" );
+
+    bool
+    Push( std::int32_t aInput, std::int32_t& aOutput ) NOEXCEPT
+    {
+        iSum += aInput;
+        if ( ++iCount < taFactor )
+        {
+            return false;
+        }
+        aOutput = static_cast< std::int32_t >( RoundedDivide( iSum, taFactor ) );
+        Reset( );
+        return true;
+    }
+
+    void
+    Reset( ) NOEXCEPT
+    {
+        iSum = 0;
+        iCount = 0;
+    }
+
+private:
+    std::int64_t iSum = 0;
+    std::uint32_t iCount = 0;
+};
+
+// Cascaded integrator-comb decimator of taOrder stages, differential delay 1, normalized to unit
+// DC gain. Steeper alias rejection than the boxcar (its taOrder 1 case) at the same cost per
+// input. Integrators wrap modulo 2^64, which the combs undo exactly.
+template < std::uint32_t taFactor, std::uint8_t taOrder >
+class CCicDecimator
+{
+public:
+    static_assert( taFactor > 0 && taOrder > 0, "" );
+
+    bool
+    Push( std::int32_t aInput, std::int32_t& aOutput ) NOEXCEPT
+    {
+        std::uint64_t value = static_cast< std::uint64_t >( std::int64_t{ aInput } );
+        for ( auto& integrator : iIntegrators )
+        {
+            integrator += value;
+            value = integrator;
+        }
+        if ( ++iCount < taFactor )
+        {
+            return false;
+        }
+        iCount = 0;
+
+        for ( auto& delay : iCombDelays )
+        {
+            const auto difference = value - delay;
+            delay = value;
+            value = difference;
+        }
+        aOutput = static_cast< std::int32_t >(
+            RoundedDivide( static_cast< std::int64_t >( value ), KGain ) );
+        return true;
+    }
+
+    void
+    Reset( ) NOEXCEPT
+    {
+        *this = CCicDecimator{ };
+    }
+
+private:
+    std::uint64_t iIntegrators[ taOrder ] = { };
+    std::uint64_t iCombDelays[ taOrder ] = { };
+    std::uint32_t iCount = 0;
+
+    static constexpr std::int64_t KGain = Power( taFactor, taOrder );
+
+    // The DC gain applied to any 32-bit input has to fit the 64-bit comb output
+    static_assert( KGain <= ( std::int64_t{ 1 } << 32 ), "CIC gain too large" );
+};
+
+// Exponential moving average with weight 2^-taShift, one output per input. The state keeps
+// taShift extra bits so small steps are not lost to rounding.
+template < std::uint8_t taShift >
+class CExponentialAverage
+{
+public:
+    static_assert( taShift > 0 && taShift < 24, "" );
+
+    bool
+    Push( std::int32_t aInput, std::int32_t& aOutput ) NOEXCEPT
+    {
+        if ( !iPrimed )
+        {
+            iState = std::int64_t{ aInput } * ( 1 << taShift );
+            iPrimed = true;
+        }
+        else
+        {
+            iState += aInput - ( ( iState + KHalf ) >> taShift );
+        }
+        aOutput = static_cast< std::int32_t >( ( iState + KHalf ) >> taShift );
+        return true;
+    }
+
+    void
+    Reset( ) NOEXCEPT
+    {
+        iState = 0;
+        iPrimed = false;
+    }
+
+private:
+    static constexpr std::int64_t KHalf = std::int64_t{ 1 } << ( taShift - 1 );
+
+    std::int64_t iState = 0;
+    bool iPrimed = false;
+};
+
+// Running median of the last taLength inputs (spike removal), one output per input. Until
+// taLength inputs arrived the median of those seen so far is reported.
+template < std::size_t taLength >
+class CMedian
+{
+public:
+    static_assert( taLength > 0 && taLength % 2 == 1, "Use an odd length" );
+
+    bool
+    Push( std::int32_t aInput, std::int32_t& aOutput ) NOEXCEPT
+    {
+        std::size_t position = iCount;
+        if ( iCount == taLength )
+        {
+            // Drop the oldest input from the sorted window
+            position = 0;
+            while ( iSorted[ position ] != iHistory[ iNext ] )
+            {
+                ++position;
+            }
+        }
+        else
+        {
+            ++iCount;
+        }
+        iHistory[ iNext ] = aInput;
+        iNext = ( iNext + 1 ) % taLength;
+
+        // Move the free slot to where aInput belongs
+        while ( position > 0 && iSorted[ position - 1 ] > aInput )
+        {
+            iSorted[ position ] = iSorted[ position - 1 ];
+            --position;
+        }
+        while ( position + 1 < iCount && iSorted[ position + 1 ] < aInput )
+        {
+            iSorted[ position ] = iSorted[ position + 1 ];
+            ++position;
+        }
+        iSorted[ position ] = aInput;
+
+        aOutput = iSorted[ iCount / 2 ];
+        return true;
+    }
+
+    void
+    Reset( ) NOEXCEPT
+    {
+        iCount = 0;
+        iNext = 0;
+    }
+
+private:
+    std::int32_t iHistory[ taLength ] = { };
+    std::int32_t iSorted[ taLength ] = { };
+    std::size_t iCount = 0;
+    std::size_t iNext = 0;
+};
+
+// Stages applied in order, an output is produced when the last stage produces one
+template < typename... taStages >
+class CChain
+{
+public:
+    bool
+    Push( std::int32_t aInput, std::int32_t& aOutput ) NOEXCEPT
+    {
+        return PushFrom( aInput, aOutput, std::integral_constant< std::size_t, 0 >{ } );
+    }
+
+    void
+    Reset( ) NOEXCEPT
+    {
+        ResetFrom( std::integral_constant< std::size_t, 0 >{ } );
+    }
+
+    template < std::size_t taIndex >
+    inline typename std::tuple_element< taIndex, std::tuple< taStages... > >::type&
+    Stage( ) NOEXCEPT
+    {
+        return std::get< taIndex >( iStages );
+    }
+
+private:
+    using TEnd = std::integral_constant< std::size_t, sizeof...( taStages ) >;
+
+    std::tuple< taStages... > iStages;
+
+    template < std::size_t taIndex >
+    bool
+    PushFrom( std::int32_t aInput,
+              std::int32_t& aOutput,
+              std::integral_constant< std::size_t, taIndex > ) NOEXCEPT
+    {
+        std::int32_t output = 0;
+        if ( !std::get< taIndex >( iStages ).Push( aInput, output ) )
+        {
+            return false;
+        }
+        return PushFrom( output, aOutput, std::integral_constant< std::size_t, taIndex + 1 >{ } );
+    }
+
+    bool
+    PushFrom( std::int32_t aInput, std::int32_t& aOutput, TEnd ) NOEXCEPT
+    {
+        aOutput = aInput;
+        return true;
+    }
+
+    template < std::size_t taIndex >
+    void
+    ResetFrom( std::integral_constant< std::size_t, taIndex > ) NOEXCEPT
+    {
+        std::get< taIndex >( iStages ).Reset( );
+        ResetFrom( std::integral_constant< std::size_t, taIndex + 1 >{ } );
+    }
+
+    void
+    ResetFrom( TEnd ) NOEXCEPT
+    {
+    }
+};
+
+}  // namespace Ina3221Filter
+
+// Per-channel filter branches fed from one acquisition stream: each raw snapshot is decoded once
+// and pushed through every branch (an Ina3221Filter::CChain or single stage) for the shunt and bus
+// voltage of all channels. Branches run at their own output rates, e.g.
+//
+//   using TFast = Ina3221Filter::CMedian< 3 >;
+//   using TTrend = Ina3221Filter::CChain< Ina3221Filter::CCicDecimator< 64, 3 >,
+//                                         Ina3221Filter::CExponentialAverage< 2 > >;
+//   CIna3221FilterPipeline< TFast, TTrend > pipeline;
+//   if ( pipeline.Push( snapshot ) & pipeline.BranchMask( 1 ) ) { use pipeline.Output< 1 >( ) }
+template < typename... taBranches >
+class CIna3221FilterPipeline
+{
+public:
+    static_assert( sizeof...( taBranches ) > 0 && sizeof...( taBranches ) <= 32, "" );
+
+    static constexpr std::size_t KBranchNumber = sizeof...( taBranches );
+
+    // Latest branch output, in Ina3221Filter fixed-point counts
+    struct COutput
+    {
+        std::int32_t iShuntVoltage[ CIina3221::KChannelNumber ] = { };
+        std::int32_t iBusVoltage[ CIina3221::KChannelNumber ] = { };
+
+        inline std::int32_t
+        ShuntVoltageUv( std::uint8_t aChannel ) const NOEXCEPT
+        {
+            return Ina3221Filter::ToMicroVolts( iShuntVoltage[ aChannel - CIina3221::KChannel1 ],
+                                                CIina3221::KShuntVoltageLsbUv );
+        }
+
+        inline std::int32_t
+        BusVoltageUv( std::uint8_t aChannel ) const NOEXCEPT
+        {
+            return Ina3221Filter::ToMicroVolts( iBusVoltage[ aChannel - CIina3221::KChannel1 ],
+                                                CIina3221::KBusVoltageLsbUv );
+        }
+    };
+
+    static constexpr std::uint32_t
+    BranchMask( std::size_t aBranch ) NOEXCEPT
+    {
+        return std::uint32_t{ 1 } << aBranch;
+    }
+
+    // Returns the mask of branches that produced a new output (see BranchMask)
+    std::uint32_t
+    Push( const std::uint16_t ( &aShuntVoltageRegister )[ CIina3221::KChannelNumber ],
+          const std::uint16_t ( &aBusVoltageRegister )[ CIina3221::KChannelNumber ] ) NOEXCEPT
+    {
+        std::int32_t shunt[ CIina3221::KChannelNumber ];
+        std::int32_t bus[ CIina3221::KChannelNumber ];
+        for ( std::uint8_t index = 0; index < CIina3221::KChannelNumber; ++index )
+        {
+            shunt[ index ] = Ina3221Filter::FromRegister( aShuntVoltageRegister[ index ] );
+            bus[ index ] = Ina3221Filter::FromRegister( aBusVoltageRegister[ index ] );
+        }
+        return PushBranches( shunt, bus, std::index_sequence_for< taBranches... >{ } );
+    }
+
+    inline std::uint32_t
+    Push( const CIina3221::CMeasurementSnapshot& aSnapshot ) NOEXCEPT
+    {
+        return Push( aSnapshot.iShuntVoltageRegister, aSnapshot.iBusVoltageRegister );
+    }
+
+    template < std::size_t taBranch >
+    inline const COutput&
+    Output( ) const NOEXCEPT
+    {
+        return std::get< taBranch >( iBranches ).iOutput;
+    }
+
+    void
+    Reset( ) NOEXCEPT
+    {
+        ResetBranches( std::index_sequence_for< taBranches... >{ } );
+    }
+
+private:
+    template < typename taBranch >
+    struct CBranch
+    {
+        taBranch iShuntVoltage[ CIina3221::KChannelNumber ];
+        taBranch iBusVoltage[ CIina3221::KChannelNumber ];
+        COutput iOutput;
+
+        bool
+        Push( const std::int32_t* aShuntVoltage, const std::int32_t* aBusVoltage ) NOEXCEPT
+        {
+            // Channels see the same input count, so all of them produce on the same sample
+            bool produced = false;
+            for ( std::uint8_t index = 0; index < CIina3221::KChannelNumber; ++index )
+            {
+                produced |= iShuntVoltage[ index ].Push( aShuntVoltage[ index ],
+                                                         iOutput.iShuntVoltage[ index ] );
+                produced |= iBusVoltage[ index ].Push( aBusVoltage[ index ],
+                                                       iOutput.iBusVoltage[ index ] );
+            }
+            return produced;
+        }
+
+        void
+        Reset( ) NOEXCEPT
+        {
+            for ( std::uint8_t index = 0; index < CIina3221::KChannelNumber; ++index )
+            {
+                iShuntVoltage[ index ].Reset( );
+                iBusVoltage[ index ].Reset( );
+            }
+            iOutput = COutput{ };
+        }
+    };
+
+    std::tuple< CBranch< taBranches >... > iBranches;
+
+    template < std::size_t... taIndex >
+    std::uint32_t
+    PushBranches( const std::int32_t* aShuntVoltage,
+                  const std::int32_t* aBusVoltage,
+                  std::index_sequence< taIndex... > ) NOEXCEPT
+    {
+        const bool produced[] = { std::get< taIndex >( iBranches ).Push( aShuntVoltage,
+                                                                         aBusVoltage )... };
+        std::uint32_t mask = 0;
+        for ( std::size_t branch = 0; branch < KBranchNumber; ++branch )
+        {
+            mask |= produced[ branch ] ? BranchMask( branch ) : 0;
+        }
+        return mask;
+    }
+
+    template < std::size_t... taIndex >
+    void
+    ResetBranches( std::index_sequence< taIndex... > ) NOEXCEPT
+    {
+        const bool unused[] = { ( std::get< taIndex >( iBranches ).Reset( ), true )... };
+        static_cast< void >( unused );
+    }
+};
+
+}  // namespace ExternalHardware
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <AbstractPlatform/common/Platform.hpp>
+
+namespace ExternalHardware
+{
+// Register access statistics of one CIina3221, compiled in with INA3221_INSTRUMENTATION.
+// Not synchronized: record and snapshot from the thread that drives the device.
+class CIna3221Instrumentation
+{
+public:
+    // Monotonic time in nanoseconds, latency histograms stay empty without a clock
+    using TClock = std::uint64_t ( * )( void* aContext );
+
+    // Registers 0x00..0x11, then manufacturer ID, die ID and any other address
+    static constexpr std::uint8_t KManufacturerIdSlot = 0x12;
+    static constexpr std::uint8_t KDieIdSlot = 0x13;
+    static constexpr std::uint8_t KOtherRegisterSlot = 0x14;
+    static constexpr std::uint8_t KRegisterSlotNumber = 0x15;
+
+    struct CRegisterStatistics
+    {
+        std::uint32_t iReads = 0;              // Successful reads, block reads count every register
+        std::uint32_t iPointerReuseReads = 0;  // Reads that skipped the register pointer write
+        std::uint32_t iWrites = 0;             // Successful writes
+        std::uint32_t iReadErrors = 0;
+        std::uint32_t iWriteErrors = 0;
+    };
+
+    // Bucket 0 holds 0 ns, bucket n holds [2^(n-1), 2^n) ns, the last bucket everything above
+    struct CLatencyHistogram
+    {
+        static constexpr std::uint8_t KBucketNumber = 32;
+
+        std::uint32_t iBuckets[ KBucketNumber ] = { };
+        std::uint64_t iCount = 0;
+        std::uint64_t iTotalNs = 0;
+        std::uint64_t iMaxNs = 0;
+
+        void
+        Record( std::uint64_t aLatencyNs ) NOEXCEPT
+        {
+            std::uint8_t bucket = 0;
+            while ( bucket < KBucketNumber - 1 && ( aLatencyNs >> bucket ) != 0 )
+            {
+                ++bucket;
+            }
+            ++iBuckets[ bucket ];
+            ++iCount;
+            iTotalNs += aLatencyNs;
+            if ( aLatencyNs > iMaxNs )
+            {
+                iMaxNs = aLatencyNs;
+            }
+        }
+
+        // Upper bound of the bucket holding the aPercent-th percentile, 0 if empty
+        std::uint64_t
+        PercentileUpperBoundNs( std::uint8_t aPercent ) const NOEXCEPT
+        {
+            const std::uint64_t rank = ( iCount * aPercent + 99 ) / 100;
+            std::uint64_t seen = 0;
+            for ( std::uint8_t bucket = 0; bucket < KBucketNumber && iCount != 0; ++bucket )
+            {
+                seen += iBuckets[ bucket ];
+                if ( seen >= rank )
+                {
+                    return bucket == 0 ? 0 : ( std::uint64_t{ 1 } << bucket ) - 1;
+                }
+            }
+            return iMaxNs;
+        }
+    };
+
+    struct CStatistics
+    {
+        CRegisterStatistics iRegisters[ KRegisterSlotNumber ];
+        CLatencyHistogram iReadLatency;   // Per read transaction, block reads count once
+        CLatencyHistogram iWriteLatency;  // Per write transaction
+        std::uint32_t iReadErrors = 0;
+        std::uint32_t iWriteErrors = 0;
+        std::uint32_t iConsecutiveErrors = 0;  // Failed transactions since the last success
+        std::uint32_t iMaxConsecutiveErrors = 0;
+    };
+
+    static constexpr std::uint8_t
+    RegisterSlot( std::uint8_t aRegisterAddress ) NOEXCEPT
+    {
+        return aRegisterAddress < KManufacturerIdSlot ? aRegisterAddress
+               : aRegisterAddress == 0xFE             ? KManufacturerIdSlot
+               : aRegisterAddress == 0xFF             ? KDieIdSlot
+                                                      : KOtherRegisterSlot;
+    }
+
+    inline void
+    SetClock( TClock aClock, void* aContext = nullptr ) NOEXCEPT
+    {
+        iClock = aClock;
+        iClockContext = aContext;
+    }
+
+    inline std::uint64_t
+    Now( ) const NOEXCEPT
+    {
+        return iClock != nullptr ? iClock( iClockContext ) : 0;
+    }
+
+    inline const CStatistics&
+    Statistics( ) const NOEXCEPT
+    {
+        return iStatistics;
+    }
+
+    inline void
+    Reset( ) NOEXCEPT
+    {
+        iStatistics = CStatistics{ };
+    }
+
+    void
+    RecordRead( std::uint8_t aRegisterAddress,
+                std::uint8_t aRegisterCount,
+                bool aPointerReuse,
+                bool aSuccess,
+                std::uint64_t aStartNs ) NOEXCEPT
+    {
+        auto& registerStatistics = iStatistics.iRegisters[ RegisterSlot( aRegisterAddress ) ];
+        if ( aSuccess )
+        {
+            for ( std::uint8_t index = 0; index < aRegisterCount; ++index )
+            {
+                ++iStatistics
+                      .iRegisters[ RegisterSlot(
+                          static_cast< std::uint8_t >( aRegisterAddress + index ) ) ]
+                      .iReads;
+            }
+            if ( aPointerReuse )
+            {
+                ++registerStatistics.iPointerReuseReads;
+            }
+        }
+        else
+        {
+            ++registerStatistics.iReadErrors;
+            ++iStatistics.iReadErrors;
+        }
+        RecordTransaction( iStatistics.iReadLatency, aSuccess, aStartNs );
+    }
+
+    void
+    RecordWrite( std::uint8_t aRegisterAddress, bool aSuccess, std::uint64_t aStartNs ) NOEXCEPT
+    {
+        auto& registerStatistics = iStatistics.iRegisters[ RegisterSlot( aRegisterAddress ) ];
+        if ( aSuccess )
+        {
+            ++registerStatistics.iWrites;
+        }
+        else
+        {
+            ++registerStatistics.iWriteErrors;
+            ++iStatistics.iWriteErrors;
+        }
+        RecordTransaction( iStatistics.iWriteLatency, aSuccess, aStartNs );
+    }
+
+private:
+    TClock iClock = nullptr;
+    void* iClockContext = nullptr;
+    CStatistics iStatistics;
+
+    void
+    RecordTransaction( CLatencyHistogram& aHistogram,
+                       bool aSuccess,
+                       std::uint64_t aStartNs ) NOEXCEPT
+    {
+        if ( iClock != nullptr )
+        {
+            aHistogram.Record( Now( ) - aStartNs );
+        }
+        if ( aSuccess )
+        {
+            iStatistics.iConsecutiveErrors = 0;
+        }
+        else if ( ++iStatistics.iConsecutiveErrors > iStatistics.iMaxConsecutiveErrors )
+        {
+            iStatistics.iMaxConsecutiveErrors = iStatistics.iConsecutiveErrors;
+        }
+    }
+};
+
+}  // namespace ExternalHardware
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <AbstractPlatform/common/Platform.hpp>
+
+namespace ExternalHardware
+{
+namespace Ina3221
+{
+// Bit field of a 16-bit register: taWidth bits starting at bit taOffset, decoded as taValue
+template < std::uint8_t taOffset, std::uint8_t taWidth, typename taValue = std::uint16_t >
+struct CRegisterField
+{
+    static_assert( taWidth > 0 && taOffset + taWidth <= 16, "Field exceeds the 16-bit register" );
+
+    using TValue = taValue;
+
+    static constexpr std::uint8_t KOffset = taOffset;
+    static constexpr std::uint8_t KWidth = taWidth;
+    static constexpr std::uint16_t KMask
+        = static_cast< std::uint16_t >( ( ( 1u << taWidth ) - 1u ) << taOffset );
+
+    static constexpr taValue
+    Get( std::uint16_t aRegisterValue ) NOEXCEPT
+    {
+        return static_cast< taValue >( ( aRegisterValue & KMask ) >> taOffset );
+    }
+
+    static constexpr std::uint16_t
+    Set( std::uint16_t aRegisterValue, taValue aFieldValue ) NOEXCEPT
+    {
+        return static_cast< std::uint16_t >(
+            ( aRegisterValue & ~KMask )
+            | ( ( static_cast< std::uint16_t >( aFieldValue ) << taOffset ) & KMask ) );
+    }
+};
+
+// Bit-exact register value with typed field access, taRegister is the derived register type
+template < typename taRegister >
+class CRegisterValue
+{
+public:
+    constexpr explicit CRegisterValue( std::uint16_t aValue ) NOEXCEPT
+        : iValue{ aValue }
+    {
+    }
+
+    constexpr std::uint16_t
+    Value( ) const NOEXCEPT
+    {
+        return iValue;
+    }
+
+    template < typename taField >
+    constexpr typename taField::TValue
+    Get( ) const NOEXCEPT
+    {
+        return taField::Get( iValue );
+    }
+
+    template < typename taField >
+    constexpr taRegister&
+    Set( typename taField::TValue aFieldValue ) NOEXCEPT
+    {
+        iValue = taField::Set( iValue, aFieldValue );
+        return static_cast< taRegister& >( *this );
+    }
+
+    constexpr bool
+    operator==( const CRegisterValue& aOther ) const NOEXCEPT
+    {
+        return iValue == aOther.iValue;
+    }
+
+    constexpr bool
+    operator!=( const CRegisterValue& aOther ) const NOEXCEPT
+    {
+        return iValue != aOther.iValue;
+    }
+
+protected:
+    std::uint16_t iValue;
+};
+
+// Register address and power-on value; per-channel registers repeat every taChannelPeriod
+// addresses
+template < std::uint8_t taAddress,
+           std::uint8_t taChannelPeriod = 0,
+           std::uint16_t taResetValue = 0x0000 >
+struct CRegisterDescriptor
+{
+    static constexpr std::uint8_t KAddress = taAddress;
+    static constexpr std::uint8_t KChannelPeriod = taChannelPeriod;
+    static constexpr std::uint16_t KResetValue = taResetValue;
+
+    static constexpr std::uint8_t
+    Address( std::uint8_t aChannel = 1 ) NOEXCEPT
+    {
+        return static_cast< std::uint8_t >( taAddress + taChannelPeriod * ( aChannel - 1 ) );
+    }
+};
+
+struct CRegisterMap
+{
+    using TConfig = CRegisterDescriptor< 0x00, 0, 0x7127 >;
+    using TShuntVoltage = CRegisterDescriptor< 0x01, 2 >;
+    using TBusVoltage = CRegisterDescriptor< 0x02, 2 >;
+    using TCriticalAlertLimit = CRegisterDescriptor< 0x07, 2, 0x7FF8 >;  // Full scale
+    using TWarningAlertLimit = CRegisterDescriptor< 0x08, 2, 0x7FF8 >;
+    using TShuntVoltageSum = CRegisterDescriptor< 0x0D >;
+    using TShuntVoltageSumLimit = CRegisterDescriptor< 0x0E, 0, 0x7FFE >;  // Full scale
+    using TMaskEnable = CRegisterDescriptor< 0x0F, 0, 0x0002 >;
+    using TPowerValidUpperLimit = CRegisterDescriptor< 0x10, 0, 0x2710 >;  // 10V
+    using TPowerValidLowerLimit = CRegisterDescriptor< 0x11, 0, 0x2328 >;  // 9V
+    using TManufacturerId = CRegisterDescriptor< 0xFE, 0, 0x5449 >;        // "TI"
+    using TDieId = CRegisterDescriptor< 0xFF, 0, 0x3220 >;
+};
+
+}  // namespace Ina3221
+}  // namespace ExternalHardware
@@ -0,0 +1,452 @@
+#include <ExternalHardware/ina3221/INA3221SampleLog.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ExternalHardware
+{
+using namespace Ina3221SampleLog;
+
+namespace
+{
+constexpr std::uint64_t KMaxTimeOffsetNs = 0xFFFFFFFFu;
+
+}  // namespace
+
+CIna3221SampleLogWriter::~CIna3221SampleLogWriter( )
+{
+    Close( );
+}
+
+CIna3221SampleLogWriter::TErrorCode
+CIna3221SampleLogWriter::Open( const char* aPath,
+                               const CIina3221::CConfig& aConfig,
+                               std::uint8_t aDeviceAddress,
+                               std::uint16_t aRecordsPerBlock ) NOEXCEPT
+{
+    if ( iFile != nullptr || aPath == nullptr || aRecordsPerBlock == 0 )
+    {
+        return AbstractPlatform::KInvalidArgumentError;
+    }
+
+    iFile = std::fopen( aPath, "wb" );
+    if ( iFile == nullptr )
+    {
+        return AbstractPlatform::KGenericError;
+    }
+
+    CFileHeader header{ };
+    std::memcpy( header.iMagic, KFileMagic, sizeof( header.iMagic ) );
+    header.iVersion = KVersion;
+    header.iHeaderSize = sizeof( CFileHeader );
+    header.iConfig = aConfig.Value( );
+    header.iDeviceAddress = aDeviceAddress;
+    header.iRegisterNumber = 2 * CIina3221::KChannelNumber;
+    header.iShuntConversionTimeUs = static_cast< std::uint16_t >(
+        CIina3221::ConversionTimeUs( aConfig.GetShuntVoltageConversionTime( ) ) );
+    header.iBusConversionTimeUs = static_cast< std::uint16_t >(
+        CIina3221::ConversionTimeUs( aConfig.GetBusVoltageConversionTime( ) ) );
+    header.iAveragingSamples = CIina3221::AveragingSamples( aConfig.GetAveragingMode( ) );
+    header.iFullScaleCounts = CIina3221::KFullScaleCounts;
+    header.iMaxShuntVoltageUv = CIina3221::KMaxShuntVoltageUv;
+    header.iMaxBusVoltageUv = CIina3221::KMaxBusVoltageUv;
+    header.iDataLShift = 3;
+    header.iRecordsPerBlock = aRecordsPerBlock;
+    header.iConversionPeriodUs = CIina3221::ConversionPeriodUs( aConfig );
+
+    iOffset = 0;
+    iRecordsPerBlock = aRecordsPerBlock;
+    iRecordCount = 0;
+    iLastTimestampNs = 0;
+    iRecords.clear( );
+    iRecords.reserve( aRecordsPerBlock );
+    iIndex.clear( );
+
+    const auto result = Write( &header, sizeof( header ) );
+    if ( result != AbstractPlatform::KOk )
+    {
+        std::fclose( iFile );
+        iFile = nullptr;
+    }
+    return result;
+}
+
+CIna3221SampleLogWriter::TErrorCode
+CIna3221SampleLogWriter::Append(
+    std::uint64_t aTimestampNs,
+    const std::uint16_t ( &aShuntVoltageRegister )[ CIina3221::KChannelNumber ],
+    const std::uint16_t ( &aBusVoltageRegister )[ CIina3221::KChannelNumber ] ) NOEXCEPT
+{
+    if ( iFile == nullptr )
+    {
+        return AbstractPlatform::KGenericError;
+    }
+    if ( iRecordCount != 0 && aTimestampNs < iLastTimestampNs )
+    {
+        return AbstractPlatform::KInvalidArgumentError;
+    }
+
+    if ( !iRecords.empty( )
+         && ( iRecords.size( ) >= iRecordsPerBlock
+              || aTimestampNs - iBlock.iBaseTimestampNs > KMaxTimeOffsetNs ) )
+    {
+        const auto result = WriteBlock( );
+        if ( result != AbstractPlatform::KOk )
+        {
+            return result;
+        }
+    }
+    if ( iRecords.empty( ) )
+    {
+        iBlock.iBaseTimestampNs = aTimestampNs;
+    }
+
+    CRecord record;
+    record.iTimeOffsetNs = static_cast< std::uint32_t >( aTimestampNs - iBlock.iBaseTimestampNs );
+    for ( std::uint8_t channel = 0; channel < CIina3221::KChannelNumber; ++channel )
+    {
+        record.iShuntVoltageRegister[ channel ] = aShuntVoltageRegister[ channel ];
+        record.iBusVoltageRegister[ channel ] = aBusVoltageRegister[ channel ];
+    }
+    iRecords.push_back( record );
+    iLastTimestampNs = aTimestampNs;
+    ++iRecordCount;
+    return AbstractPlatform::KOk;
+}
+
+CIna3221SampleLogWriter::TErrorCode
+CIna3221SampleLogWriter::Flush( ) NOEXCEPT
+{
+    if ( iFile == nullptr )
+    {
+        return AbstractPlatform::KGenericError;
+    }
+    const auto result = WriteBlock( );
+    if ( result != AbstractPlatform::KOk )
+    {
+        return result;
+    }
+    return std::fflush( iFile ) == 0 ? AbstractPlatform::KOk : AbstractPlatform::KGenericError;
+}
+
+CIna3221SampleLogWriter::TErrorCode
+CIna3221SampleLogWriter::Close( ) NOEXCEPT
+{
+    if ( iFile == nullptr )
+    {
+        return AbstractPlatform::KOk;
+    }
+
+    auto result = WriteBlock( );
+    if ( result == AbstractPlatform::KOk )
+    {
+        CFileFooter footer;
+        footer.iIndexOffset = iOffset;
+        footer.iBlockCount = static_cast< std::uint32_t >( iIndex.size( ) );
+        footer.iMagic = KFooterMagic;
+
+        result = Write( iIndex.data( ), iIndex.size( ) * sizeof( CIndexEntry ) );
+        if ( result == AbstractPlatform::KOk )
+        {
+            result = Write( &footer, sizeof( footer ) );
+        }
+    }
+
+    if ( std::fclose( iFile ) != 0 && result == AbstractPlatform::KOk )
+    {
+        result = AbstractPlatform::KGenericError;
+    }
+    iFile = nullptr;
+    return result;
+}
+
+CIna3221SampleLogWriter::TErrorCode
+CIna3221SampleLogWriter::WriteBlock( ) NOEXCEPT
+{
+    if ( iRecords.empty( ) )
+    {
+        return AbstractPlatform::KOk;
+    }
+
+    iBlock.iMagic = KBlockMagic;
+    iBlock.iRecordCount = static_cast< std::uint32_t >( iRecords.size( ) );
+    const CIndexEntry entry{ iBlock.iBaseTimestampNs, iOffset };
+
+    auto result = Write( &iBlock, sizeof( iBlock ) );
+    if ( result == AbstractPlatform::KOk )
+    {
+        result = Write( iRecords.data( ), iRecords.size( ) * sizeof( CRecord ) );
+    }
+    if ( result == AbstractPlatform::KOk )
+    {
+        // A failed block must not be indexed, the footer would point past the written data
+        iIndex.push_back( entry );
+    }
+    iRecords.clear( );
+    return result;
+}
+
+CIna3221SampleLogWriter::TErrorCode
+CIna3221SampleLogWriter::Write( const void* aData, std::size_t aSize ) NOEXCEPT
+{
+    if ( aSize != 0 && std::fwrite( aData, aSize, 1, iFile ) != 1 )
+    {
+        return AbstractPlatform::KGenericError;
+    }
+    iOffset += aSize;
+    return AbstractPlatform::KOk;
+}
+
+CIna3221SampleLogReader::~CIna3221SampleLogReader( )
+{
+    Close( );
+}
+
+CIna3221SampleLogReader::TErrorCode
+CIna3221SampleLogReader::Open( const char* aPath ) NOEXCEPT
+{
+    if ( iData != nullptr || aPath == nullptr )
+    {
+        return AbstractPlatform::KInvalidArgumentError;
+    }
+
+    const int file = ::open( aPath, O_RDONLY );
+    if ( file < 0 )
+    {
+        return AbstractPlatform::KGenericError;
+    }
+
+    struct stat status;
+    void* mapping = MAP_FAILED;
+    if ( ::fstat( file, &status ) == 0
+         && static_cast< std::size_t >( status.st_size ) >= sizeof( CFileHeader ) )
+    {
+        mapping = ::mmap( nullptr,
+                          static_cast< std::size_t >( status.st_size ),
+                          PROT_READ,
+                          MAP_SHARED,
+                          file,
+                          0 );
+    }
+    ::close( file );
+    if ( mapping == MAP_FAILED )
+    {
+        return AbstractPlatform::KGenericError;
+    }
+
+    iData = static_cast< const std::uint8_t* >( mapping );
+    iSize = static_cast< std::size_t >( status.st_size );
+    iHeader = reinterpret_cast< const CFileHeader* >( iData );
+    ::madvise( mapping, iSize, MADV_SEQUENTIAL );
+
+    if ( std::memcmp( iHeader->iMagic, KFileMagic, sizeof( KFileMagic ) ) != 0
+         || iHeader->iVersion != KVersion || iHeader->iHeaderSize != sizeof( CFileHeader )
+         || iHeader->iRegisterNumber != 2 * CIina3221::KChannelNumber )
+    {
+        Close( );
+        return AbstractPlatform::KInvalidArgumentError;
+    }
+
+    iComplete = LoadIndex( );
+    if ( !iComplete && !ScanBlocks( ) )
+    {
+        Close( );
+        return AbstractPlatform::KGenericError;
+    }
+    return AbstractPlatform::KOk;
+}
+
+void
+CIna3221SampleLogReader::Close( ) NOEXCEPT
+{
+    if ( iData != nullptr )
+    {
+        ::munmap( const_cast< std::uint8_t* >( iData ), iSize );
+    }
+    iData = nullptr;
+    iSize = 0;
+    iHeader = nullptr;
+    iIndex.clear( );
+    iRecordCount = 0;
+    iComplete = false;
+}
+
+const CBlockHeader*
+CIna3221SampleLogReader::Block( std::size_t aBlock ) const NOEXCEPT
+{
+    return reinterpret_cast< const CBlockHeader* >( iData + iIndex[ aBlock ].iOffset );
+}
+
+bool
+CIna3221SampleLogReader::LoadIndex( ) NOEXCEPT
+{
+    if ( iSize < sizeof( CFileHeader ) + sizeof( CFileFooter ) )
+    {
+        return false;
+    }
+    const auto& footer
+        = *reinterpret_cast< const CFileFooter* >( iData + iSize - sizeof( CFileFooter ) );
+    const std::uint64_t indexSize = std::uint64_t{ footer.iBlockCount } * sizeof( CIndexEntry );
+    // Offsets come from the file, compare by subtraction so that they cannot overflow
+    const std::uint64_t footerOffset = iSize - sizeof( CFileFooter );
+    if ( footer.iMagic != KFooterMagic || footer.iIndexOffset < sizeof( CFileHeader )
+         || footer.iIndexOffset > footerOffset || indexSize != footerOffset - footer.iIndexOffset )
+    {
+        return false;
+    }
+
+    const auto* entries = reinterpret_cast< const CIndexEntry* >( iData + footer.iIndexOffset );
+    iIndex.assign( entries, entries + footer.iBlockCount );
+    iRecordCount = 0;
+    for ( const auto& entry : iIndex )
+    {
+        // Every block must lie before the index
+        if ( entry.iOffset > footer.iIndexOffset
+             || footer.iIndexOffset - entry.iOffset < sizeof( CBlockHeader ) )
+        {
+            iIndex.clear( );
+            return false;
+        }
+        const auto* block = reinterpret_cast< const CBlockHeader* >( iData + entry.iOffset );
+        if ( block->iMagic != KBlockMagic
+             || std::uint64_t{ block->iRecordCount } * sizeof( CRecord )
+                    > footer.iIndexOffset - entry.iOffset - sizeof( CBlockHeader ) )
+        {
+            iIndex.clear( );
+            return false;
+        }
+        iRecordCount += block->iRecordCount;
+    }
+    return true;
+}
+
+bool
+CIna3221SampleLogReader::ScanBlocks( ) NOEXCEPT
+{
+    // Stops at the first incomplete or foreign block, e.g. a capture cut off mid-write
+    iIndex.clear( );
+    iRecordCount = 0;
+    std::uint64_t offset = sizeof( CFileHeader );
+    while ( offset + sizeof( CBlockHeader ) <= iSize )
+    {
+        const auto* block = reinterpret_cast< const CBlockHeader* >( iData + offset );
+        const std::uint64_t blockSize
+            = sizeof( CBlockHeader ) + std::uint64_t{ block->iRecordCount } * sizeof( CRecord );
+        if ( block->iMagic != KBlockMagic || block->iRecordCount == 0
+             || offset + blockSize > iSize )
+        {
+            break;
+        }
+        iIndex.push_back( CIndexEntry{ block->iBaseTimestampNs, offset } );
+        iRecordCount += block->iRecordCount;
+        offset += blockSize;
+    }
+    return true;
+}
+
+void
+CIna3221SampleLogReader::CIterator::Load( std::size_t aBlock,
+                                          std::uint32_t aRecordInBlock ) NOEXCEPT
+{
+    iBlock = aBlock;
+    iRecordInBlock = aRecordInBlock;
+    if ( iReader == nullptr || aBlock >= iReader->iIndex.size( ) )
+    {
+        iView = CSampleView{ };
+        return;
+    }
+
+    const auto* block = iReader->Block( aBlock );
+    const auto* records = reinterpret_cast< const CRecord* >( block + 1 );
+    iView.iRecord = records + aRecordInBlock;
+    iView.iTimestampNs = block->iBaseTimestampNs + iView.iRecord->iTimeOffsetNs;
+}
+
+CIna3221SampleLogReader::CIterator&
+CIna3221SampleLogReader::CIterator::operator++( ) NOEXCEPT
+{
+    if ( iView.iRecord == nullptr )
+    {
+        return *this;
+    }
+    if ( iRecordInBlock + 1 < iReader->Block( iBlock )->iRecordCount )
+    {
+        Load( iBlock, iRecordInBlock + 1 );
+    }
+    else
+    {
+        Load( iBlock + 1, 0 );
+    }
+    return *this;
+}
+
+CIna3221SampleLogReader::CIterator
+CIna3221SampleLogReader::begin( ) const NOEXCEPT
+{
+    CIterator iterator;
+    iterator.iReader = this;
+    iterator.Load( 0, 0 );
+    return iterator;
+}
+
+CIna3221SampleLogReader::CIterator
+CIna3221SampleLogReader::end( ) const NOEXCEPT
+{
+    CIterator iterator;
+    iterator.iReader = this;
+    iterator.Load( iIndex.size( ), 0 );
+    return iterator;
+}
+
+CIna3221SampleLogReader::CIterator
+CIna3221SampleLogReader::Find( std::uint64_t aTimestampNs ) const NOEXCEPT
+{
+    // Last block starting strictly before the time. Samples at the time itself may end that
+    // block and continue in the following ones, which all start at or after it.
+    const auto next = std::lower_bound(
+        iIndex.begin( ),
+        iIndex.end( ),
+        aTimestampNs,
+        []( const CIndexEntry& aEntry, std::uint64_t aTime ) {
+            return aEntry.iFirstTimestampNs < aTime;
+        } );
+    const std::size_t blockIndex
+        = next == iIndex.begin( ) ? 0 : static_cast< std::size_t >( next - iIndex.begin( ) ) - 1;
+
+    CIterator iterator;
+    iterator.iReader = this;
+    if ( blockIndex >= iIndex.size( ) )
+    {
+        iterator.Load( iIndex.size( ), 0 );
+        return iterator;
+    }
+
+    const auto* block = Block( blockIndex );
+    const auto* records = reinterpret_cast< const CRecord* >( block + 1 );
+    const std::uint64_t offsetNs
+        = aTimestampNs > block->iBaseTimestampNs ? aTimestampNs - block->iBaseTimestampNs : 0;
+    const auto* record = std::lower_bound(
+        records,
+        records + block->iRecordCount,
+        offsetNs,
+        []( const CRecord& aRecord, std::uint64_t aOffset ) {
+            return aRecord.iTimeOffsetNs < aOffset;
+        } );
+
+    const auto recordInBlock = static_cast< std::uint32_t >( record - records );
+    if ( recordInBlock < block->iRecordCount )
+    {
+        iterator.Load( blockIndex, recordInBlock );
+    }
+    else
+    {
+        iterator.Load( blockIndex + 1, 0 );
+    }
+    return iterator;
+}
+
+}  // namespace ExternalHardware
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <ExternalHardware/ina3221/INA3221.hpp>
+#include <ExternalHardware/ina3221/INA3221Sampler.hpp>
+
+namespace ExternalHardware
+{
+// Binary capture format for raw INA3221 samples, little-endian:
+//
+//   CFileHeader                          64 bytes, device configuration and decode constants
+//   { CBlockHeader, CRecord[count] }...  blocks of up to iRecordsPerBlock records
+//   CIndexEntry[blockCount]              optional sparse index, one entry per block
+//   CFileFooter                          optional, present once the writer was closed
+//
+// A record holds the raw shunt/bus register values of all channels and its time as an offset
+// from the block base time, so records are 16 bytes (about a tenth of a CSV line) and can be read
+// in place. Files without footer (capture interrupted) are indexed by scanning the block headers.
+namespace Ina3221SampleLog
+{
+static constexpr char KFileMagic[ 8 ] = { 'I', 'N', 'A', '3', '2', '2', '1', 'S' };
+static constexpr std::uint16_t KVersion = 1;
+static constexpr std::uint32_t KBlockMagic = 0x4B4C4249;  // "IBLK"
+static constexpr std::uint32_t KFooterMagic = 0x58444E49;  // "INDX"
+
+struct CFileHeader
+{
+    char iMagic[ 8 ];
+    std::uint16_t iVersion;
+    std::uint16_t iHeaderSize;
+    std::uint16_t iConfig;  // CIina3221::CConfig register value
+    std::uint8_t iDeviceAddress;
+    std::uint8_t iRegisterNumber;  // Registers per record
+    std::uint16_t iShuntConversionTimeUs;
+    std::uint16_t iBusConversionTimeUs;
+    std::uint16_t iAveragingSamples;
+    std::int16_t iFullScaleCounts;
+    std::int32_t iMaxShuntVoltageUv;  // Voltage at iFullScaleCounts
+    std::int32_t iMaxBusVoltageUv;
+    std::uint8_t iDataLShift;  // Position of the counts in the register words
+    std::uint8_t iReserved0;
+    std::uint16_t iRecordsPerBlock;
+    std::uint32_t iConversionPeriodUs;
+    std::uint8_t iReserved[ 24 ];
+};
+
+struct CBlockHeader
+{
+    std::uint32_t iMagic;
+    std::uint32_t iRecordCount;
+    std::uint64_t iBaseTimestampNs;  // Record times are offsets from this
+};
+
+struct CRecord
+{
+    std::uint32_t iTimeOffsetNs;
+    std::uint16_t iShuntVoltageRegister[ CIina3221::KChannelNumber ];
+    std::uint16_t iBusVoltageRegister[ CIina3221::KChannelNumber ];
+};
+
+struct CIndexEntry
+{
+    std::uint64_t iFirstTimestampNs;
+    std::uint64_t iOffset;  // File offset of the block header
+};
+
+struct CFileFooter
+{
+    std::uint64_t iIndexOffset;
+    std::uint32_t iBlockCount;
+    std::uint32_t iMagic;
+};
+
+static_assert( sizeof( CFileHeader ) == 64, "" );
+static_assert( sizeof( CBlockHeader ) == 16, "" );
+static_assert( sizeof( CRecord ) == 16, "" );
+static_assert( sizeof( CIndexEntry ) == 16, "" );
+static_assert( sizeof( CFileFooter ) == 16, "" );
+#if defined( __BYTE_ORDER__ )
+static_assert( __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "The log is read and written in place" );
+#endif
+
+}  // namespace Ina3221SampleLog
+
+// Streams samples into a capture file. Records are buffered per block, a block is written when
+// full, on Flush, or when the next time offset would not fit 32 bits.
+class CIna3221SampleLogWriter
+{
+public:
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    static constexpr std::uint16_t KDefaultRecordsPerBlock = 256;
+
+    CIna3221SampleLogWriter( ) = default;
+    ~CIna3221SampleLogWriter( );
+
+    CIna3221SampleLogWriter( const CIna3221SampleLogWriter& ) = delete;
+    CIna3221SampleLogWriter& operator=( const CIna3221SampleLogWriter& ) = delete;
+
+    TErrorCode Open( const char* aPath,
+                     const CIina3221::CConfig& aConfig,
+                     std::uint8_t aDeviceAddress = CIina3221::KDefaultAddress,
+                     std::uint16_t aRecordsPerBlock = KDefaultRecordsPerBlock ) NOEXCEPT;
+
+    // Timestamps must not decrease
+    TErrorCode Append( std::uint64_t aTimestampNs,
+                       const std::uint16_t ( &aShuntVoltageRegister )[ CIina3221::KChannelNumber ],
+                       const std::uint16_t ( &aBusVoltageRegister )[ CIina3221::KChannelNumber ] )
+        NOEXCEPT;
+
+    inline TErrorCode
+    Append( const CIna3221Sampler::CSample& aSample ) NOEXCEPT
+    {
+        return Append( aSample.iTimestampNs, aSample.iShuntVoltageRegister,
+                       aSample.iBusVoltageRegister );
+    }
+
+    inline TErrorCode
+    Append( std::uint64_t aTimestampNs, const CIina3221::CMeasurementSnapshot& aSnapshot ) NOEXCEPT
+    {
+        return Append( aTimestampNs, aSnapshot.iShuntVoltageRegister,
+                       aSnapshot.iBusVoltageRegister );
+    }
+
+    // Writes the buffered records as a (possibly short) block and flushes the file
+    TErrorCode Flush( ) NOEXCEPT;
+
+    // Writes the remaining records, the sparse index and the footer
+    TErrorCode Close( ) NOEXCEPT;
+
+    inline bool
+    IsOpen( ) const NOEXCEPT
+    {
+        return iFile != nullptr;
+    }
+
+    inline std::uint64_t
+    RecordCount( ) const NOEXCEPT
+    {
+        return iRecordCount;
+    }
+
+private:
+    std::FILE* iFile = nullptr;
+    std::uint64_t iOffset = 0;
+    std::uint16_t iRecordsPerBlock = KDefaultRecordsPerBlock;
+    std::uint64_t iRecordCount = 0;
+    std::uint64_t iLastTimestampNs = 0;
+    Ina3221SampleLog::CBlockHeader iBlock{ };
+    std::vector< Ina3221SampleLog::CRecord > iRecords;
+    std::vector< Ina3221SampleLog::CIndexEntry > iIndex;
+
+    TErrorCode WriteBlock( ) NOEXCEPT;
+    TErrorCode Write( const void* aData, std::size_t aSize ) NOEXCEPT;
+};
+
+// Memory-maps a capture file for zero-copy iteration and random access by time (POSIX)
+class CIna3221SampleLogReader
+{
+public:
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    // A record in place in the mapping together with its absolute time
+    class CSampleView
+    {
+    public:
+        inline std::uint64_t
+        TimestampNs( ) const NOEXCEPT
+        {
+            return iTimestampNs;
+        }
+
+        inline const Ina3221SampleLog::CRecord&
+        Record( ) const NOEXCEPT
+        {
+            return *iRecord;
+        }
+
+        inline std::uint16_t
+        ShuntVoltageRegister( std::uint8_t aChannel ) const NOEXCEPT
+        {
+            return iRecord->iShuntVoltageRegister[ aChannel - CIina3221::KChannel1 ];
+        }
+
+        inline std::uint16_t
+        BusVoltageRegister( std::uint8_t aChannel ) const NOEXCEPT
+        {
+            return iRecord->iBusVoltageRegister[ aChannel - CIina3221::KChannel1 ];
+        }
+
+        inline std::int32_t
+        ShuntVoltageUv( std::uint8_t aChannel ) const NOEXCEPT
+        {
+            return CIina3221::ShuntRegisterToUv( ShuntVoltageRegister( aChannel ) );
+        }
+
+        inline std::int32_t
+        BusVoltageUv( std::uint8_t aChannel ) const NOEXCEPT
+        {
+            return CIina3221::BusRegisterToUv( BusVoltageRegister( aChannel ) );
+        }
+
+    private:
+        friend class CIna3221SampleLogReader;
+
+        const Ina3221SampleLog::CRecord* iRecord = nullptr;
+        std::uint64_t iTimestampNs = 0;
+    };
+
+    class CIterator
+    {
+    public:
+        inline const CSampleView&
+        operator*( ) const NOEXCEPT
+        {
+            return iView;
+        }
+
+        inline const CSampleView*
+        operator->( ) const NOEXCEPT
+        {
+            return &iView;
+        }
+
+        CIterator& operator++( ) NOEXCEPT;
+
+        inline bool
+        operator==( const CIterator& aOther ) const NOEXCEPT
+        {
+            return iView.iRecord == aOther.iView.iRecord;
+        }
+
+        inline bool
+        operator!=( const CIterator& aOther ) const NOEXCEPT
+        {
+            return !( *this == aOther );
+        }
+
+    private:
+        friend class CIna3221SampleLogReader;
+
+        const CIna3221SampleLogReader* iReader = nullptr;
+        std::size_t iBlock = 0;
+        std::uint32_t iRecordInBlock = 0;
+        CSampleView iView;
+
+        void Load( std::size_t aBlock, std::uint32_t aRecordInBlock ) NOEXCEPT;
+    };
+
+    CIna3221SampleLogReader( ) = default;
+    ~CIna3221SampleLogReader( );
+
+    CIna3221SampleLogReader( const CIna3221SampleLogReader& ) = delete;
+    CIna3221SampleLogReader& operator=( const CIna3221SampleLogReader& ) = delete;
+
+    TErrorCode Open( const char* aPath ) NOEXCEPT;
+
+    void Close( ) NOEXCEPT;
+
+    inline const Ina3221SampleLog::CFileHeader&
+    Header( ) const NOEXCEPT
+    {
+        return *iHeader;
+    }
+
+    inline CIina3221::CConfig
+    Config( ) const NOEXCEPT
+    {
+        return CIina3221::CConfig{ iHeader->iConfig };
+    }
+
+    inline std::uint64_t
+    RecordCount( ) const NOEXCEPT
+    {
+        return iRecordCount;
+    }
+
+    // False if the footer was missing and the index was rebuilt by scanning
+    inline bool
+    IsComplete( ) const NOEXCEPT
+    {
+        return iComplete;
+    }
+
+    CIterator begin( ) const NOEXCEPT;
+    CIterator end( ) const NOEXCEPT;
+
+    // First sample at or after aTimestampNs, end() if none
+    CIterator Find( std::uint64_t aTimestampNs ) const NOEXCEPT;
+
+private:
+    const std::uint8_t* iData = nullptr;
+    std::size_t iSize = 0;
+    const Ina3221SampleLog::CFileHeader* iHeader = nullptr;
+    std::vector< Ina3221SampleLog::CIndexEntry > iIndex;
+    std::uint64_t iRecordCount = 0;
+    bool iComplete = false;
+
+    const Ina3221SampleLog::CBlockHeader* Block( std::size_t aBlock ) const NOEXCEPT;
+    bool LoadIndex( ) NOEXCEPT;
+    bool ScanBlocks( ) NOEXCEPT;
+};
+
+}  // namespace ExternalHardware
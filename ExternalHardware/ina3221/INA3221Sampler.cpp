@@ -0,0 +1,89 @@
+#include <ExternalHardware/ina3221/INA3221Sampler.hpp>
+
+namespace ExternalHardware
+{
+CIna3221Sampler::CIna3221Sampler( CIina3221& aDevice,
+                                  CSample* aStorage,
+                                  std::size_t aCapacity ) NOEXCEPT
+    : iDevice{ aDevice },
+      iBuffer{ aStorage, aCapacity }
+{
+}
+
+CIna3221Sampler::~CIna3221Sampler( )
+{
+    Stop( );
+}
+
+CIna3221Sampler::TErrorCode
+CIna3221Sampler::Start( std::chrono::microseconds aPollPeriod )
+{
+    if ( iBuffer.Capacity( ) == 0 )
+    {
+        return AbstractPlatform::KInvalidArgumentError;
+    }
+    if ( iRunning.exchange( true ) )
+    {
+        return AbstractPlatform::KGenericError;
+    }
+
+    iPollPeriod = aPollPeriod;
+    iThread = std::thread{ &CIna3221Sampler::Run, this };
+    return AbstractPlatform::KOk;
+}
+
+void
+CIna3221Sampler::Stop( )
+{
+    iRunning.store( false, std::memory_order_release );
+    if ( iThread.joinable( ) )
+    {
+        iThread.join( );
+    }
+}
+
+void
+CIna3221Sampler::Run( ) NOEXCEPT
+{
+    CIina3221::CMeasurementSnapshot snapshot;
+    auto nextPoll = TClock::now( );
+
+    while ( iRunning.load( std::memory_order_acquire ) )
+    {
+        const auto result = iDevice.ReadSnapshotIfReady( snapshot );
+        if ( result != AbstractPlatform::KOk )
+        {
+            iErrorCount.fetch_add( 1, std::memory_order_relaxed );
+            iLastError.store( result, std::memory_order_relaxed );
+        }
+        else if ( snapshot.iFresh )
+        {
+            CSample sample;
+            sample.iTimestampNs = static_cast< std::uint64_t >(
+                std::chrono::duration_cast< std::chrono::nanoseconds >(
+                    TClock::now( ).time_since_epoch( ) )
+                    .count( ) );
+            for ( std::uint8_t channel = 0; channel < CIina3221::KChannelNumber; ++channel )
+            {
+                sample.iShuntVoltageRegister[ channel ] = snapshot.iShuntVoltageRegister[ channel ];
+                sample.iBusVoltageRegister[ channel ] = snapshot.iBusVoltageRegister[ channel ];
+            }
+
+            if ( !iBuffer.TryPush( sample ) )
+            {
+                iOverrunCount.fetch_add( 1, std::memory_order_relaxed );
+            }
+        }
+
+        nextPoll += iPollPeriod;
+        const auto now = TClock::now( );
+        if ( nextPoll < now )
+        {
+            // Fell behind (slow bus or long poll period), do not try to catch up with a burst
+            nextPoll = now;
+        }
+        std::this_thread::sleep_until( nextPoll );
+    }
+}
+
+}  // namespace ExternalHardware
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <ExternalHardware/ina3221/INA3221.hpp>
+#include <ExternalHardware/ina3221/SpscRingBuffer.hpp>
+
+namespace ExternalHardware
+{
+// Runs acquisition of one CIina3221 on a dedicated thread and queues timestamped raw samples.
+// The device must not be used by other threads while the sampler is running.
+class CIna3221Sampler
+{
+public:
+    using TErrorCode = AbstractPlatform::TErrorCode;
+    using TClock = std::chrono::steady_clock;
+
+    struct CSample
+    {
+        std::uint64_t iTimestampNs;  // TClock time the registers were read
+        std::uint16_t iShuntVoltageRegister[ CIina3221::KChannelNumber ];
+        std::uint16_t iBusVoltageRegister[ CIina3221::KChannelNumber ];
+    };
+
+    // aStorage holds aCapacity samples and must outlive the sampler
+    CIna3221Sampler( CIina3221& aDevice, CSample* aStorage, std::size_t aCapacity ) NOEXCEPT;
+    ~CIna3221Sampler( );
+
+    CIna3221Sampler( const CIna3221Sampler& ) = delete;
+    CIna3221Sampler& operator=( const CIna3221Sampler& ) = delete;
+
+    // Starts the sampling thread, polling for a new conversion every aPollPeriod
+    TErrorCode Start( std::chrono::microseconds aPollPeriod );
+
+    void Stop( );
+
+    inline bool
+    IsRunning( ) const NOEXCEPT
+    {
+        return iRunning.load( std::memory_order_acquire );
+    }
+
+    // Consumer side: moves up to aMaxCount queued samples into aSamples
+    inline std::size_t
+    Drain( CSample* aSamples, std::size_t aMaxCount ) NOEXCEPT
+    {
+        return iBuffer.PopBatch( aSamples, aMaxCount );
+    }
+
+    // Samples discarded because the buffer was full
+    inline std::uint64_t
+    OverrunCount( ) const NOEXCEPT
+    {
+        return iOverrunCount.load( std::memory_order_relaxed );
+    }
+
+    // Failed bus operations on the sampling thread
+    inline std::uint64_t
+    ErrorCount( ) const NOEXCEPT
+    {
+        return iErrorCount.load( std::memory_order_relaxed );
+    }
+
+    inline TErrorCode
+    LastError( ) const NOEXCEPT
+    {
+        return iLastError.load( std::memory_order_relaxed );
+    }
+
+private:
+    CIina3221& iDevice;
+    CSpscRingBuffer< CSample > iBuffer;
+    std::thread iThread;
+    std::chrono::microseconds iPollPeriod{ 0 };
+
+    std::atomic< bool > iRunning{ false };
+    std::atomic< std::uint64_t > iOverrunCount{ 0 };
+    std::atomic< std::uint64_t > iErrorCount{ 0 };
+    std::atomic< TErrorCode > iLastError{ AbstractPlatform::KOk };
+
+    void Run( ) NOEXCEPT;
+};
+
+}  // namespace ExternalHardware
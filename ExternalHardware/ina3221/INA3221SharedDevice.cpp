@@ -0,0 +1,165 @@
+#include <ExternalHardware/ina3221/INA3221SharedDevice.hpp>
+
+namespace ExternalHardware
+{
+CIna3221SharedDevice::CIna3221SharedDevice( CIina3221& aDevice,
+                                            CIna3221BusArbiter& aArbiter,
+                                            std::chrono::nanoseconds aStaleness ) NOEXCEPT
+    : iDevice{ aDevice },
+      iArbiter{ aArbiter },
+      iStalenessNs{ aStaleness.count( ) },
+      iCacheRegisters{ { 0 }, { 0 } }
+{
+}
+
+CIna3221SharedDevice::TErrorCode
+CIna3221SharedDevice::ReadSnapshot( CIina3221::CMeasurementSnapshot& aSnapshot,
+                                    std::chrono::nanoseconds aMaxAge ) NOEXCEPT
+{
+    iRequests.fetch_add( 1, std::memory_order_relaxed );
+
+    // Data sampled at or after this time is fresh enough for the request
+    const auto requestNs = NowNs( );
+    const auto maxAgeNs = static_cast< std::uint64_t >( aMaxAge.count( ) > 0 ? aMaxAge.count( )
+                                                                             : 0 );
+    const auto oldestNs = requestNs > maxAgeNs ? requestNs - maxAgeNs : 1;
+
+    std::uint16_t registers[ KRegisterNumber ];
+    if ( LoadCache( registers ) >= oldestNs )
+    {
+        iCacheHits.fetch_add( 1, std::memory_order_relaxed );
+        CIina3221::DecodeSnapshot( registers, aSnapshot );
+        return AbstractPlatform::KOk;
+    }
+
+    std::lock_guard< std::mutex > refreshLock{ iRefreshMutex };
+
+    // Another caller may have refreshed while this one waited
+    if ( LoadCache( registers ) >= oldestNs )
+    {
+        iCoalesced.fetch_add( 1, std::memory_order_relaxed );
+        CIina3221::DecodeSnapshot( registers, aSnapshot );
+        return AbstractPlatform::KOk;
+    }
+
+    const auto startNs = NowNs( );
+    TErrorCode result = AbstractPlatform::KOk;
+    {
+        std::lock_guard< CIna3221BusArbiter > busLock{ iArbiter };
+        result = iDevice.ReadSnapshot( aSnapshot );
+    }
+    if ( result != AbstractPlatform::KOk )
+    {
+        iErrors.fetch_add( 1, std::memory_order_relaxed );
+        return result;
+    }
+    iBusReads.fetch_add( 1, std::memory_order_relaxed );
+    PublishCache( &aSnapshot, startNs );
+    return AbstractPlatform::KOk;
+}
+
+bool
+CIna3221SharedDevice::CachedSnapshot( CIina3221::CMeasurementSnapshot& aSnapshot,
+                                      std::uint64_t* aTimestampNs ) const NOEXCEPT
+{
+    std::uint16_t registers[ KRegisterNumber ];
+    const auto timestampNs = LoadCache( registers );
+    if ( timestampNs == 0 )
+    {
+        return false;
+    }
+    CIina3221::DecodeSnapshot( registers, aSnapshot );
+    if ( aTimestampNs != nullptr )
+    {
+        *aTimestampNs = timestampNs;
+    }
+    return true;
+}
+
+CIna3221SharedDevice::CStatistics
+CIna3221SharedDevice::Statistics( ) const NOEXCEPT
+{
+    CStatistics statistics;
+    statistics.iRequests = iRequests.load( std::memory_order_relaxed );
+    statistics.iCacheHits = iCacheHits.load( std::memory_order_relaxed );
+    statistics.iCoalesced = iCoalesced.load( std::memory_order_relaxed );
+    statistics.iBusReads = iBusReads.load( std::memory_order_relaxed );
+    statistics.iErrors = iErrors.load( std::memory_order_relaxed );
+    return statistics;
+}
+
+void
+CIna3221SharedDevice::ResetStatistics( ) NOEXCEPT
+{
+    iRequests.store( 0, std::memory_order_relaxed );
+    iCacheHits.store( 0, std::memory_order_relaxed );
+    iCoalesced.store( 0, std::memory_order_relaxed );
+    iBusReads.store( 0, std::memory_order_relaxed );
+    iErrors.store( 0, std::memory_order_relaxed );
+}
+
+std::uint64_t
+CIna3221SharedDevice::NowNs( ) NOEXCEPT
+{
+    return static_cast< std::uint64_t >(
+        std::chrono::duration_cast< std::chrono::nanoseconds >(
+            TClock::now( ).time_since_epoch( ) )
+            .count( ) );
+}
+
+std::uint64_t
+CIna3221SharedDevice::LoadCache( std::uint16_t ( &aRegisters )[ KRegisterNumber ] ) const NOEXCEPT
+{
+    std::uint32_t sequence = 0;
+    std::uint64_t timestampNs = 0;
+    std::uint64_t words[ 2 ] = { };
+    do
+    {
+        sequence = iSequence.load( std::memory_order_acquire );
+        if ( sequence & 1 )
+        {
+            continue;
+        }
+        timestampNs = iCacheTimestampNs.load( std::memory_order_relaxed );
+        words[ 0 ] = iCacheRegisters[ 0 ].load( std::memory_order_relaxed );
+        words[ 1 ] = iCacheRegisters[ 1 ].load( std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_acquire );
+    } while ( ( sequence & 1 ) || sequence != iSequence.load( std::memory_order_relaxed ) );
+
+    for ( std::uint8_t index = 0; index < KRegisterNumber; ++index )
+    {
+        aRegisters[ index ]
+            = static_cast< std::uint16_t >( words[ index / 4 ] >> ( index % 4 * 16 ) );
+    }
+    return timestampNs;
+}
+
+void
+CIna3221SharedDevice::PublishCache( const CIina3221::CMeasurementSnapshot* aSnapshot,
+                                    std::uint64_t aTimestampNs ) NOEXCEPT
+{
+    // Single writer, serialized by iRefreshMutex
+    std::uint64_t words[ 2 ] = { };
+    if ( aSnapshot != nullptr )
+    {
+        for ( std::uint8_t channel = 0; channel < CIina3221::KChannelNumber; ++channel )
+        {
+            const std::uint8_t index = channel * 2;
+            words[ index / 4 ] |= std::uint64_t{ aSnapshot->iShuntVoltageRegister[ channel ] }
+                                  << ( index % 4 * 16 );
+            words[ ( index + 1 ) / 4 ]
+                |= std::uint64_t{ aSnapshot->iBusVoltageRegister[ channel ] }
+                   << ( ( index + 1 ) % 4 * 16 );
+        }
+    }
+
+    const auto sequence = iSequence.load( std::memory_order_relaxed );
+    iSequence.store( sequence + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+    iCacheTimestampNs.store( aSnapshot != nullptr ? aTimestampNs : 0, std::memory_order_relaxed );
+    iCacheRegisters[ 0 ].store( words[ 0 ], std::memory_order_relaxed );
+    iCacheRegisters[ 1 ].store( words[ 1 ], std::memory_order_relaxed );
+    iSequence.store( sequence + 2, std::memory_order_release );
+}
+
+}  // namespace ExternalHardware
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <ExternalHardware/ina3221/INA3221.hpp>
+
+namespace ExternalHardware
+{
+// Serializes the transactions of all shared devices on one I2C bus (BasicLockable)
+class CIna3221BusArbiter
+{
+public:
+    inline void
+    lock( )
+    {
+        iMutex.lock( );
+    }
+
+    inline void
+    unlock( )
+    {
+        iMutex.unlock( );
+    }
+
+private:
+    std::mutex iMutex;
+};
+
+// Thread-safe facade of one CIina3221 for many concurrent consumers.
+//
+// Snapshot reads are served from a cache while it is younger than the staleness window. The
+// cache is published with a sequence lock, so that path takes no lock. A stale cache is refreshed
+// by one caller while concurrent callers wait for it and share the result: any refresh started
+// after a request arrived satisfies that request, even with a zero staleness window. All other
+// device access goes through Execute. The wrapped device must not be used directly meanwhile.
+class CIna3221SharedDevice
+{
+public:
+    using TErrorCode = AbstractPlatform::TErrorCode;
+    using TClock = std::chrono::steady_clock;
+
+    struct CStatistics
+    {
+        std::uint64_t iRequests = 0;
+        std::uint64_t iCacheHits = 0;  // Served lock-free from a fresh cache
+        std::uint64_t iCoalesced = 0;  // Served by a refresh of another caller
+        std::uint64_t iBusReads = 0;   // Snapshot reads on the bus
+        std::uint64_t iErrors = 0;
+    };
+
+    CIna3221SharedDevice( CIina3221& aDevice,
+                          CIna3221BusArbiter& aArbiter,
+                          std::chrono::nanoseconds aStaleness = std::chrono::milliseconds{ 1 } )
+        NOEXCEPT;
+
+    CIna3221SharedDevice( const CIna3221SharedDevice& ) = delete;
+    CIna3221SharedDevice& operator=( const CIna3221SharedDevice& ) = delete;
+
+    inline void
+    SetStaleness( std::chrono::nanoseconds aStaleness ) NOEXCEPT
+    {
+        iStalenessNs.store( aStaleness.count( ), std::memory_order_relaxed );
+    }
+
+    // Snapshot no older than the staleness window
+    inline TErrorCode
+    ReadSnapshot( CIina3221::CMeasurementSnapshot& aSnapshot ) NOEXCEPT
+    {
+        return ReadSnapshot(
+            aSnapshot,
+            std::chrono::nanoseconds{ iStalenessNs.load( std::memory_order_relaxed ) } );
+    }
+
+    TErrorCode ReadSnapshot( CIina3221::CMeasurementSnapshot& aSnapshot,
+                             std::chrono::nanoseconds aMaxAge ) NOEXCEPT;
+
+    // Latest cached snapshot of any age without touching the bus, false if there is none
+    bool CachedSnapshot( CIina3221::CMeasurementSnapshot& aSnapshot,
+                         std::uint64_t* aTimestampNs = nullptr ) const NOEXCEPT;
+
+    // Runs aOperation( CIina3221& ) with exclusive access to the device and its bus, e.g. for
+    // configuration changes, and drops the cache afterwards
+    template < typename taOperation >
+    TErrorCode
+    Execute( taOperation&& aOperation )
+    {
+        std::lock_guard< std::mutex > refreshLock{ iRefreshMutex };
+        TErrorCode result = AbstractPlatform::KOk;
+        {
+            std::lock_guard< CIna3221BusArbiter > busLock{ iArbiter };
+            result = aOperation( iDevice );
+        }
+        PublishCache( nullptr, 0 );
+        return result;
+    }
+
+    CStatistics Statistics( ) const NOEXCEPT;
+
+    void ResetStatistics( ) NOEXCEPT;
+
+    static std::uint64_t NowNs( ) NOEXCEPT;
+
+private:
+    static constexpr std::uint8_t KRegisterNumber = CIina3221::KMeasurementRegisterNumber;
+
+    CIina3221& iDevice;
+    CIna3221BusArbiter& iArbiter;
+    std::mutex iRefreshMutex;  // Held by the refreshing caller, ordered before the bus arbiter
+    std::atomic< std::int64_t > iStalenessNs;
+
+    // Sequence lock: odd while the refreshing caller updates the payload
+    std::atomic< std::uint32_t > iSequence{ 0 };
+    std::atomic< std::uint64_t > iCacheTimestampNs{ 0 };  // 0 while the cache is empty
+    // Registers in snapshot order (ch1 shunt, ch1 bus, ...), four per word
+    std::atomic< std::uint64_t > iCacheRegisters[ 2 ];
+
+    std::atomic< std::uint64_t > iRequests{ 0 };
+    std::atomic< std::uint64_t > iCacheHits{ 0 };
+    std::atomic< std::uint64_t > iCoalesced{ 0 };
+    std::atomic< std::uint64_t > iBusReads{ 0 };
+    std::atomic< std::uint64_t > iErrors{ 0 };
+
+    std::uint64_t LoadCache( std::uint16_t ( &aRegisters )[ KRegisterNumber ] ) const NOEXCEPT;
+    void PublishCache( const CIina3221::CMeasurementSnapshot* aSnapshot,
+                       std::uint64_t aTimestampNs ) NOEXCEPT;
+};
+
+}  // namespace ExternalHardware
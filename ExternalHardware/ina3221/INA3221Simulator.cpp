@@ -0,0 +1,488 @@
+#include <ExternalHardware/ina3221/INA3221Simulator.hpp>
+
+namespace ExternalHardware
+{
+namespace
+{
+using TRegisterMap = Ina3221::CRegisterMap;
+using CConfig = CIina3221::CConfig;
+using CMaskEnable = CIina3221::CMaskEnable;
+
+constexpr std::uint8_t KRegConfig = TRegisterMap::TConfig::KAddress;
+constexpr std::uint8_t KRegMaskEnable = TRegisterMap::TMaskEnable::KAddress;
+constexpr std::uint8_t KRegSum = TRegisterMap::TShuntVoltageSum::KAddress;
+constexpr std::uint8_t KRegSumLimit = TRegisterMap::TShuntVoltageSumLimit::KAddress;
+constexpr std::uint8_t KRegPowerValidUpper = TRegisterMap::TPowerValidUpperLimit::KAddress;
+constexpr std::uint8_t KRegPowerValidLower = TRegisterMap::TPowerValidLowerLimit::KAddress;
+
+constexpr std::uint16_t KVoltageDataMask = 0xFFF8;  // Bits 15..3
+constexpr std::uint16_t KSumDataMask = 0xFFFE;      // Bits 15..1
+
+// Start, stop and acknowledge overhead of a transaction in bit times
+constexpr std::uint32_t KBitsPerByte = 9;
+constexpr std::uint32_t KStartStopBits = 2;
+
+inline std::int32_t
+Counts( std::uint16_t aRegisterValue, std::uint8_t aDataLShift ) NOEXCEPT
+{
+    return static_cast< std::int16_t >( aRegisterValue ) >> aDataLShift;
+}
+
+inline std::int32_t
+VoltageToCounts( float aVoltage, std::int32_t aLsbUv, std::int32_t aMaxCounts ) NOEXCEPT
+{
+    const float counts = aVoltage * 1e6f / static_cast< float >( aLsbUv );
+    auto rounded = static_cast< std::int32_t >( counts < 0.0f ? counts - 0.5f : counts + 0.5f );
+    rounded = rounded > aMaxCounts ? aMaxCounts : rounded;
+    rounded = rounded < -aMaxCounts ? -aMaxCounts : rounded;
+    return rounded;
+}
+
+inline std::uint16_t
+CountsToRegister( std::int32_t aCounts, std::uint8_t aDataLShift ) NOEXCEPT
+{
+    return static_cast< std::uint16_t >( aCounts * ( 1 << aDataLShift ) );
+}
+
+inline std::uint16_t
+UpdateFlag( std::uint16_t aRegisterValue, std::uint16_t aFlag, bool aCondition, bool aLatched )
+{
+    if ( aCondition )
+    {
+        return aRegisterValue | aFlag;
+    }
+    return aLatched ? aRegisterValue : static_cast< std::uint16_t >( aRegisterValue & ~aFlag );
+}
+
+}  // namespace
+
+CIna3221Simulator::CIna3221Simulator( std::uint8_t aAddress ) NOEXCEPT
+    : iAddress{ aAddress }
+{
+    PowerOnReset( );
+}
+
+void
+CIna3221Simulator::PowerOnReset( ) NOEXCEPT
+{
+    for ( auto& registerValue : iRegisters )
+    {
+        registerValue = 0;
+    }
+
+    iRegisters[ KRegConfig ] = TRegisterMap::TConfig::KResetValue;
+    for ( std::uint8_t channel = CIina3221::KChannel1; channel <= CIina3221::KChannelNumber;
+          ++channel )
+    {
+        iRegisters[ TRegisterMap::TCriticalAlertLimit::Address( channel ) ]
+            = TRegisterMap::TCriticalAlertLimit::KResetValue;
+        iRegisters[ TRegisterMap::TWarningAlertLimit::Address( channel ) ]
+            = TRegisterMap::TWarningAlertLimit::KResetValue;
+    }
+    iRegisters[ KRegSumLimit ] = TRegisterMap::TShuntVoltageSumLimit::KResetValue;
+    iRegisters[ KRegMaskEnable ] = TRegisterMap::TMaskEnable::KResetValue;
+    iRegisters[ KRegPowerValidUpper ] = TRegisterMap::TPowerValidUpperLimit::KResetValue;
+    iRegisters[ KRegPowerValidLower ] = TRegisterMap::TPowerValidLowerLimit::KResetValue;
+    iRegisters[ TRegisterMap::TManufacturerId::KAddress ]
+        = TRegisterMap::TManufacturerId::KResetValue;
+    iRegisters[ TRegisterMap::TDieId::KAddress ] = TRegisterMap::TDieId::KResetValue;
+
+    iRegisterPointer = 0;
+    StartCycle( iTimeNs );
+}
+
+void
+CIna3221Simulator::SetShuntVoltage( std::uint8_t aChannel, float aVoltage ) NOEXCEPT
+{
+    iShuntInputs[ aChannel - CIina3221::KChannel1 ].iVoltage = aVoltage;
+}
+
+void
+CIna3221Simulator::SetBusVoltage( std::uint8_t aChannel, float aVoltage ) NOEXCEPT
+{
+    iBusInputs[ aChannel - CIina3221::KChannel1 ].iVoltage = aVoltage;
+}
+
+void
+CIna3221Simulator::SetShuntWaveform( std::uint8_t aChannel,
+                                     TWaveform aWaveform,
+                                     void* aContext ) NOEXCEPT
+{
+    auto& input = iShuntInputs[ aChannel - CIina3221::KChannel1 ];
+    input.iWaveform = aWaveform;
+    input.iContext = aContext;
+}
+
+void
+CIna3221Simulator::SetBusWaveform( std::uint8_t aChannel,
+                                   TWaveform aWaveform,
+                                   void* aContext ) NOEXCEPT
+{
+    auto& input = iBusInputs[ aChannel - CIina3221::KChannel1 ];
+    input.iWaveform = aWaveform;
+    input.iContext = aContext;
+}
+
+bool
+CIna3221Simulator::AcceptTransaction( ) NOEXCEPT
+{
+    if ( !iPresent )
+    {
+        return false;
+    }
+    if ( iPendingNacks > 0 )
+    {
+        --iPendingNacks;
+        return false;
+    }
+    return true;
+}
+
+bool
+CIna3221Simulator::Write( const std::uint8_t* aData, std::size_t aSize ) NOEXCEPT
+{
+    if ( !AcceptTransaction( ) )
+    {
+        return false;
+    }
+    if ( aSize == 0 )
+    {
+        return true;
+    }
+
+    iRegisterPointer = aData[ 0 ];
+    if ( aSize >= 3 )
+    {
+        WriteRegister( iRegisterPointer,
+                       static_cast< std::uint16_t >( ( aData[ 1 ] << 8 ) | aData[ 2 ] ) );
+    }
+    return true;
+}
+
+bool
+CIna3221Simulator::Read( std::uint8_t* aData, std::size_t aSize ) NOEXCEPT
+{
+    if ( !AcceptTransaction( ) )
+    {
+        return false;
+    }
+
+    std::uint8_t registerAddress = iRegisterPointer;
+    std::uint16_t registerValue = 0;
+    for ( std::size_t i = 0; i < aSize; ++i )
+    {
+        if ( i % 2 == 0 )
+        {
+            registerValue = ReadRegister( registerAddress );
+            if ( iBlockReadAutoIncrement )
+            {
+                ++registerAddress;
+            }
+        }
+        aData[ i ] = static_cast< std::uint8_t >( i % 2 == 0 ? registerValue >> 8 : registerValue );
+    }
+    return true;
+}
+
+void
+CIna3221Simulator::WriteRegister( std::uint8_t aRegisterAddress, std::uint16_t aValue ) NOEXCEPT
+{
+    switch ( aRegisterAddress )
+    {
+    case KRegConfig:
+        if ( CConfig{ aValue }.GetReset( ) )
+        {
+            PowerOnReset( );
+            return;
+        }
+        iRegisters[ KRegConfig ] = aValue;
+        iRegisters[ KRegMaskEnable ] &= ~CMaskEnable::TCVRF::KMask;
+        StartCycle( iTimeNs );
+        return;
+
+    case TRegisterMap::TCriticalAlertLimit::Address( 1 ):
+    case TRegisterMap::TWarningAlertLimit::Address( 1 ):
+    case TRegisterMap::TCriticalAlertLimit::Address( 2 ):
+    case TRegisterMap::TWarningAlertLimit::Address( 2 ):
+    case TRegisterMap::TCriticalAlertLimit::Address( 3 ):
+    case TRegisterMap::TWarningAlertLimit::Address( 3 ):
+    case KRegPowerValidUpper:
+    case KRegPowerValidLower:
+        iRegisters[ aRegisterAddress ] = aValue & KVoltageDataMask;
+        return;
+
+    case KRegSumLimit:
+        iRegisters[ aRegisterAddress ] = aValue & KSumDataMask;
+        return;
+
+    case KRegMaskEnable:
+        iRegisters[ KRegMaskEnable ] = static_cast< std::uint16_t >(
+            ( iRegisters[ KRegMaskEnable ] & CMaskEnable::KFlagsMask )
+            | ( aValue & CMaskEnable::KControlMask ) );
+        return;
+
+    default:
+        // Measurement and ID registers are read-only
+        return;
+    }
+}
+
+std::uint16_t
+CIna3221Simulator::ReadRegister( std::uint8_t aRegisterAddress ) NOEXCEPT
+{
+    const auto value = iRegisters[ aRegisterAddress ];
+    if ( aRegisterAddress == KRegMaskEnable )
+    {
+        // Reading clears the conversion-ready flag and every latched alert flag
+        const CMaskEnable maskEnable{ value };
+        std::uint16_t cleared = CMaskEnable::TCVRF::KMask;
+        if ( maskEnable.GetCriticalLatchEnable( ) )
+        {
+            cleared |= CMaskEnable::TCF1::KMask | CMaskEnable::TCF2::KMask
+                       | CMaskEnable::TCF3::KMask | CMaskEnable::TSF::KMask;
+        }
+        if ( maskEnable.GetWarningLatchEnable( ) )
+        {
+            cleared |= CMaskEnable::TWF1::KMask | CMaskEnable::TWF2::KMask
+                       | CMaskEnable::TWF3::KMask;
+        }
+        iRegisters[ KRegMaskEnable ] = value & ~cleared;
+    }
+    return value;
+}
+
+std::uint64_t
+CIna3221Simulator::CyclePeriodNs( ) const NOEXCEPT
+{
+    return std::uint64_t{ CIina3221::ConversionPeriodUs( CConfig{ iRegisters[ KRegConfig ] } ) }
+           * 1000;
+}
+
+void
+CIna3221Simulator::StartCycle( std::uint64_t aTimeNs ) NOEXCEPT
+{
+    // Power-down modes and configurations without enabled channels have a zero period
+    iCycleStartNs = aTimeNs;
+    iConverting = CyclePeriodNs( ) != 0;
+}
+
+void
+CIna3221Simulator::AdvanceTo( std::uint64_t aTimeNs ) NOEXCEPT
+{
+    while ( iConverting )
+    {
+        const auto periodNs = CyclePeriodNs( );
+        const auto cycleEndNs = iCycleStartNs + periodNs;
+        if ( cycleEndNs > aTimeNs )
+        {
+            break;
+        }
+
+        CompleteCycle( cycleEndNs );
+
+        const CConfig config{ iRegisters[ KRegConfig ] };
+        const auto mode = static_cast< std::uint8_t >( config.GetOperationMode( ) );
+        iCycleStartNs = cycleEndNs;
+        iConverting = ( mode & 0x4 ) != 0;  // Continuous modes restart immediately
+    }
+    iTimeNs = aTimeNs;
+}
+
+float
+CIna3221Simulator::Sample( const CInput& aInput, std::uint64_t aTimeNs ) NOEXCEPT
+{
+    return aInput.iWaveform != nullptr ? aInput.iWaveform( aInput.iContext, aTimeNs )
+                                       : aInput.iVoltage;
+}
+
+void
+CIna3221Simulator::CompleteCycle( std::uint64_t aTimeNs ) NOEXCEPT
+{
+    const CConfig config{ iRegisters[ KRegConfig ] };
+    const auto mode = static_cast< std::uint8_t >( config.GetOperationMode( ) );
+    const bool shuntEnabled = ( mode & 0x1 ) != 0;
+    const bool busEnabled = ( mode & 0x2 ) != 0;
+
+    CMaskEnable maskEnable{ iRegisters[ KRegMaskEnable ] };
+    const bool criticalLatched = maskEnable.GetCriticalLatchEnable( );
+    const bool warningLatched = maskEnable.GetWarningLatchEnable( );
+    std::uint16_t flags = maskEnable.Value( );
+
+    constexpr std::uint16_t KCriticalFlags[]
+        = { CMaskEnable::TCF1::KMask, CMaskEnable::TCF2::KMask, CMaskEnable::TCF3::KMask };
+    constexpr std::uint16_t KWarningFlags[]
+        = { CMaskEnable::TWF1::KMask, CMaskEnable::TWF2::KMask, CMaskEnable::TWF3::KMask };
+
+    std::int32_t sum = 0;
+    bool allAboveUpper = true;
+    bool anyBelowLower = false;
+    const auto powerValidUpper = Counts( iRegisters[ KRegPowerValidUpper ], 3 );
+    const auto powerValidLower = Counts( iRegisters[ KRegPowerValidLower ], 3 );
+
+    for ( std::uint8_t channel = CIina3221::KChannel1; channel <= CIina3221::KChannelNumber;
+          ++channel )
+    {
+        if ( !config.GetChannelEnable( channel ) )
+        {
+            continue;
+        }
+        const auto index = channel - CIina3221::KChannel1;
+
+        if ( shuntEnabled )
+        {
+            const auto shunt
+                = VoltageToCounts( Sample( iShuntInputs[ index ], aTimeNs ),
+                                   CIina3221::KShuntVoltageLsbUv, CIina3221::KFullScaleCounts );
+            iRegisters[ TRegisterMap::TShuntVoltage::Address( channel ) ]
+                = CountsToRegister( shunt, 3 );
+
+            const auto critical
+                = Counts( iRegisters[ TRegisterMap::TCriticalAlertLimit::Address( channel ) ], 3 );
+            const auto warning
+                = Counts( iRegisters[ TRegisterMap::TWarningAlertLimit::Address( channel ) ], 3 );
+            flags = UpdateFlag( flags, KCriticalFlags[ index ], shunt > critical, criticalLatched );
+            flags = UpdateFlag( flags, KWarningFlags[ index ], shunt > warning, warningLatched );
+
+            if ( maskEnable.GetSummationChannel( channel ) )
+            {
+                sum += shunt;
+            }
+        }
+
+        if ( busEnabled )
+        {
+            const auto bus
+                = VoltageToCounts( Sample( iBusInputs[ index ], aTimeNs ),
+                                   CIina3221::KBusVoltageLsbUv, CIina3221::KFullScaleCounts );
+            iRegisters[ TRegisterMap::TBusVoltage::Address( channel ) ]
+                = CountsToRegister( bus, 3 );
+            allAboveUpper = allAboveUpper && bus > powerValidUpper;
+            anyBelowLower = anyBelowLower || bus < powerValidLower;
+        }
+    }
+
+    if ( shuntEnabled )
+    {
+        iRegisters[ KRegSum ] = CountsToRegister( sum, 1 );
+        flags = UpdateFlag( flags, CMaskEnable::TSF::KMask,
+                            sum > Counts( iRegisters[ KRegSumLimit ], 1 ), criticalLatched );
+    }
+
+    if ( busEnabled )
+    {
+        // Power-valid has hysteresis: set above the upper limit, cleared below the lower one
+        if ( allAboveUpper )
+        {
+            flags |= CMaskEnable::TPVF::KMask;
+        }
+        else if ( anyBelowLower )
+        {
+            flags &= ~CMaskEnable::TPVF::KMask;
+        }
+    }
+
+    iRegisters[ KRegMaskEnable ] = flags | CMaskEnable::TCVRF::KMask;
+    ++iConversionCount;
+}
+
+CSimulatedI2CBus::CSimulatedI2CBus( std::uint32_t aBusFrequencyHz,
+                                    std::uint32_t aTransactionOverheadNs ) NOEXCEPT
+    : iBusFrequencyHz{ aBusFrequencyHz },
+      iTransactionOverheadNs{ aTransactionOverheadNs }
+{
+}
+
+bool
+CSimulatedI2CBus::Attach( CIna3221Simulator& aDevice ) NOEXCEPT
+{
+    for ( auto& device : iDevices )
+    {
+        if ( device == nullptr )
+        {
+            device = &aDevice;
+            device->AdvanceTo( iTimeNs );
+            return true;
+        }
+    }
+    return false;
+}
+
+CIna3221Simulator*
+CSimulatedI2CBus::Find( std::uint8_t aAddress ) NOEXCEPT
+{
+    for ( auto device : iDevices )
+    {
+        if ( device != nullptr && device->Address( ) == aAddress )
+        {
+            return device;
+        }
+    }
+    return nullptr;
+}
+
+void
+CSimulatedI2CBus::Advance( std::uint64_t aDurationNs ) NOEXCEPT
+{
+    iTimeNs += aDurationNs;
+    for ( auto device : iDevices )
+    {
+        if ( device != nullptr )
+        {
+            device->AdvanceTo( iTimeNs );
+        }
+    }
+}
+
+void
+CSimulatedI2CBus::Charge( std::size_t aDataBytes, bool aNoStop ) NOEXCEPT
+{
+    // Address byte plus data bytes, each with its acknowledge bit
+    const std::uint64_t bits = ( 1 + aDataBytes ) * KBitsPerByte + ( aNoStop ? 1 : KStartStopBits );
+    Advance( bits * 1000000000ull / iBusFrequencyHz + iTransactionOverheadNs );
+}
+
+int
+CSimulatedI2CBus::Write( std::uint8_t aAddress,
+                         const std::uint8_t* aData,
+                         std::size_t aSize,
+                         bool aNoStop )
+{
+    ++iStatistics.iTransactions;
+    ++iStatistics.iWriteTransactions;
+
+    auto device = Find( aAddress );
+    if ( device == nullptr || !device->Write( aData, aSize ) )
+    {
+        ++iStatistics.iNacks;
+        Charge( 0, false );
+        return -1;
+    }
+
+    iStatistics.iBytes += aSize;
+    Charge( aSize, aNoStop );
+    return static_cast< int >( aSize );
+}
+
+int
+CSimulatedI2CBus::Read( std::uint8_t aAddress,
+                        std::uint8_t* aData,
+                        std::size_t aSize,
+                        bool aNoStop )
+{
+    ++iStatistics.iTransactions;
+    ++iStatistics.iReadTransactions;
+
+    auto device = Find( aAddress );
+    if ( device == nullptr || !device->Read( aData, aSize ) )
+    {
+        ++iStatistics.iNacks;
+        Charge( 0, false );
+        return -1;
+    }
+
+    iStatistics.iBytes += aSize;
+    Charge( aSize, aNoStop );
+    return static_cast< int >( aSize );
+}
+
+}  // namespace ExternalHardware
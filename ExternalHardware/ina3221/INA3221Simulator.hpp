@@ -0,0 +1,199 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/i2c/AbstractI2C.hpp>
+#include <ExternalHardware/ina3221/INA3221.hpp>
+
+namespace ExternalHardware
+{
+// Register-level model of one INA3221 for host-side testing and benchmarking. Time is virtual
+// and advanced by the bus it is attached to (CSimulatedI2CBus).
+//
+// Modelled: power-on register values, die/manufacturer ID, reset through the config register,
+// the register pointer (set by every write, reused by pointer-less reads), read-only measurement
+// registers, conversion timing from the config register (all channels are updated at the end of
+// a conversion cycle), single-shot and power-down modes, critical/warning/summation/power-valid
+// alert flags with latch and transparent modes, CVRF cleared by mask/enable reads and config
+// writes, and NACK injection.
+class CIna3221Simulator
+{
+public:
+    static constexpr std::uint16_t KDieId = Ina3221::CRegisterMap::TDieId::KResetValue;
+    static constexpr std::uint16_t KManufacturerId
+        = Ina3221::CRegisterMap::TManufacturerId::KResetValue;
+
+    // Input waveform: volts at virtual time aTimeNs
+    using TWaveform = float ( * )( void* aContext, std::uint64_t aTimeNs );
+
+    explicit CIna3221Simulator( std::uint8_t aAddress = CIina3221::KDefaultAddress ) NOEXCEPT;
+
+    inline std::uint8_t
+    Address( ) const NOEXCEPT
+    {
+        return iAddress;
+    }
+
+    // Power-on reset of the register file
+    void PowerOnReset( ) NOEXCEPT;
+
+    // Constant inputs, used for channels without a waveform
+    void SetShuntVoltage( std::uint8_t aChannel, float aVoltage ) NOEXCEPT;
+    void SetBusVoltage( std::uint8_t aChannel, float aVoltage ) NOEXCEPT;
+
+    void SetShuntWaveform( std::uint8_t aChannel,
+                           TWaveform aWaveform,
+                           void* aContext = nullptr ) NOEXCEPT;
+    void SetBusWaveform( std::uint8_t aChannel,
+                         TWaveform aWaveform,
+                         void* aContext = nullptr ) NOEXCEPT;
+
+    // Fault injection: NACK the next aCount transactions addressed to this device
+    inline void
+    NackNextTransactions( std::uint32_t aCount ) NOEXCEPT
+    {
+        iPendingNacks = aCount;
+    }
+
+    // An absent device NACKs every transaction
+    inline void
+    SetPresent( bool aPresent ) NOEXCEPT
+    {
+        iPresent = aPresent;
+    }
+
+    inline void
+    SetDieId( std::uint16_t aDieId ) NOEXCEPT
+    {
+        iRegisters[ 0xFF ] = aDieId;
+    }
+
+    // Whether a multi-word read continues with the following registers or repeats the pointed one
+    inline void
+    SetBlockReadAutoIncrement( bool aAutoIncrement ) NOEXCEPT
+    {
+        iBlockReadAutoIncrement = aAutoIncrement;
+    }
+
+    // Direct register access bypassing the bus, for test setup and inspection
+    inline std::uint16_t
+    Register( std::uint8_t aRegisterAddress ) const NOEXCEPT
+    {
+        return iRegisters[ aRegisterAddress ];
+    }
+
+    inline std::uint8_t
+    RegisterPointer( ) const NOEXCEPT
+    {
+        return iRegisterPointer;
+    }
+
+    inline std::uint64_t
+    ConversionCount( ) const NOEXCEPT
+    {
+        return iConversionCount;
+    }
+
+    // Bus side, data in wire (big-endian) order. Returns false on NACK.
+    bool Write( const std::uint8_t* aData, std::size_t aSize ) NOEXCEPT;
+    bool Read( std::uint8_t* aData, std::size_t aSize ) NOEXCEPT;
+
+    // Runs conversions up to virtual time aTimeNs
+    void AdvanceTo( std::uint64_t aTimeNs ) NOEXCEPT;
+
+private:
+    struct CInput
+    {
+        float iVoltage = 0.0f;
+        TWaveform iWaveform = nullptr;
+        void* iContext = nullptr;
+    };
+
+    const std::uint8_t iAddress;
+    std::uint16_t iRegisters[ 256 ] = { };
+    std::uint8_t iRegisterPointer = 0;
+    bool iPresent = true;
+    bool iBlockReadAutoIncrement = true;
+    std::uint32_t iPendingNacks = 0;
+
+    CInput iShuntInputs[ CIina3221::KChannelNumber ];
+    CInput iBusInputs[ CIina3221::KChannelNumber ];
+
+    std::uint64_t iTimeNs = 0;
+    std::uint64_t iCycleStartNs = 0;
+    bool iConverting = false;
+    std::uint64_t iConversionCount = 0;
+
+    bool AcceptTransaction( ) NOEXCEPT;
+    void WriteRegister( std::uint8_t aRegisterAddress, std::uint16_t aValue ) NOEXCEPT;
+    std::uint16_t ReadRegister( std::uint8_t aRegisterAddress ) NOEXCEPT;
+    void StartCycle( std::uint64_t aTimeNs ) NOEXCEPT;
+    void CompleteCycle( std::uint64_t aTimeNs ) NOEXCEPT;
+    std::uint64_t CyclePeriodNs( ) const NOEXCEPT;
+    static float Sample( const CInput& aInput, std::uint64_t aTimeNs ) NOEXCEPT;
+};
+
+// IAbstractI2CBus with up to four attached simulated devices and a virtual clock that is
+// charged with the wire time of every transaction
+class CSimulatedI2CBus : public AbstractPlatform::IAbstractI2CBus
+{
+public:
+    static constexpr std::uint8_t KMaxDeviceNumber = 4;
+
+    struct CStatistics
+    {
+        std::uint64_t iTransactions = 0;
+        std::uint64_t iReadTransactions = 0;
+        std::uint64_t iWriteTransactions = 0;
+        std::uint64_t iBytes = 0;  // Data bytes, address bytes excluded
+        std::uint64_t iNacks = 0;
+    };
+
+    explicit CSimulatedI2CBus( std::uint32_t aBusFrequencyHz = 400000,
+                               std::uint32_t aTransactionOverheadNs = 0 ) NOEXCEPT;
+
+    bool Attach( CIna3221Simulator& aDevice ) NOEXCEPT;
+
+    int Read( std::uint8_t aAddress,
+              std::uint8_t* aData,
+              std::size_t aSize,
+              bool aNoStop ) override;
+    int Write( std::uint8_t aAddress,
+               const std::uint8_t* aData,
+               std::size_t aSize,
+               bool aNoStop ) override;
+
+    inline std::uint64_t
+    NowNs( ) const NOEXCEPT
+    {
+        return iTimeNs;
+    }
+
+    // Models the host waiting (e.g. sleeping until a conversion deadline)
+    void Advance( std::uint64_t aDurationNs ) NOEXCEPT;
+
+    inline const CStatistics&
+    Statistics( ) const NOEXCEPT
+    {
+        return iStatistics;
+    }
+
+    inline void
+    ResetStatistics( ) NOEXCEPT
+    {
+        iStatistics = CStatistics{ };
+    }
+
+private:
+    const std::uint32_t iBusFrequencyHz;
+    const std::uint32_t iTransactionOverheadNs;
+    CIna3221Simulator* iDevices[ KMaxDeviceNumber ] = { };
+    std::uint64_t iTimeNs = 0;
+    CStatistics iStatistics;
+
+    CIna3221Simulator* Find( std::uint8_t aAddress ) NOEXCEPT;
+    void Charge( std::size_t aDataBytes, bool aNoStop ) NOEXCEPT;
+};
+
+}  // namespace ExternalHardware
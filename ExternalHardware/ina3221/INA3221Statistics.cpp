@@ -0,0 +1,180 @@
+#include <ExternalHardware/ina3221/INA3221Statistics.hpp>
+
+#include <cmath>
+
+namespace ExternalHardware
+{
+namespace
+{
+constexpr std::int32_t KSubBucketBits = 3;
+
+static_assert( CIna3221Statistics::KSubBucketNumber == 1 << KSubBucketBits, "" );
+static_assert( CIna3221Statistics::KExactMagnitude == 2 * CIna3221Statistics::KSubBucketNumber,
+               "The first split octave starts right after the exact magnitudes" );
+
+constexpr std::int32_t KFirstSplitOctave = 4;  // log2( KExactMagnitude )
+
+// Magnitude 0..32767 to its bucket within one sign
+inline std::size_t
+MagnitudeBucket( std::int32_t aMagnitude ) NOEXCEPT
+{
+    if ( aMagnitude < CIna3221Statistics::KExactMagnitude )
+    {
+        return static_cast< std::size_t >( aMagnitude );
+    }
+    std::int32_t octave = KFirstSplitOctave;
+    while ( ( aMagnitude >> ( octave + 1 ) ) != 0 )
+    {
+        ++octave;
+    }
+    const auto subBucket = ( aMagnitude >> ( octave - KSubBucketBits ) )
+                           - CIna3221Statistics::KSubBucketNumber;
+    return static_cast< std::size_t >( CIna3221Statistics::KExactMagnitude
+                                       + ( octave - KFirstSplitOctave )
+                                             * CIna3221Statistics::KSubBucketNumber
+                                       + subBucket );
+}
+
+inline std::int32_t
+MagnitudeBucketMidpoint( std::size_t aBucket ) NOEXCEPT
+{
+    const auto bucket = static_cast< std::int32_t >( aBucket );
+    if ( bucket < CIna3221Statistics::KExactMagnitude )
+    {
+        return bucket;
+    }
+    const auto split = bucket - CIna3221Statistics::KExactMagnitude;
+    const auto octave = split / CIna3221Statistics::KSubBucketNumber + KFirstSplitOctave;
+    const auto subBucket = split % CIna3221Statistics::KSubBucketNumber;
+    const auto shift = octave - KSubBucketBits;
+    const auto low = ( CIna3221Statistics::KSubBucketNumber + subBucket ) << shift;
+    return low + ( ( ( 1 << shift ) - 1 ) >> 1 );
+}
+
+}  // namespace
+
+void
+CIna3221Statistics::Reset( ) NOEXCEPT
+{
+    *this = CIna3221Statistics{ };
+}
+
+void
+CIna3221Statistics::Add( std::int16_t aCounts ) NOEXCEPT
+{
+    if ( iCount == 0 )
+    {
+        iMin = aCounts;
+        iMax = aCounts;
+    }
+    else
+    {
+        iMin = aCounts < iMin ? aCounts : iMin;
+        iMax = aCounts > iMax ? aCounts : iMax;
+    }
+
+    // Welford update
+    ++iCount;
+    const double delta = aCounts - iMean;
+    iMean += delta / iCount;
+    iM2 += delta * ( aCounts - iMean );
+
+    ++iBuckets[ Bucket( aCounts ) ];
+}
+
+void
+CIna3221Statistics::Merge( const CIna3221Statistics& aOther ) NOEXCEPT
+{
+    if ( aOther.iCount == 0 )
+    {
+        return;
+    }
+    if ( iCount == 0 )
+    {
+        *this = aOther;
+        return;
+    }
+
+    iMin = aOther.iMin < iMin ? aOther.iMin : iMin;
+    iMax = aOther.iMax > iMax ? aOther.iMax : iMax;
+
+    // Pairwise combination of the Welford moments (Chan et al.)
+    const double count = static_cast< double >( iCount ) + aOther.iCount;
+    const double delta = aOther.iMean - iMean;
+    iMean += delta * aOther.iCount / count;
+    iM2 += aOther.iM2 + delta * delta * iCount * aOther.iCount / count;
+    iCount += aOther.iCount;
+
+    for ( std::size_t bucket = 0; bucket < KBucketNumber; ++bucket )
+    {
+        iBuckets[ bucket ] += aOther.iBuckets[ bucket ];
+    }
+}
+
+double
+CIna3221Statistics::StdDev( ) const NOEXCEPT
+{
+    return std::sqrt( Variance( ) );
+}
+
+std::int16_t
+CIna3221Statistics::Quantile( float aQuantile ) const NOEXCEPT
+{
+    if ( iCount == 0 || aQuantile <= 0.0f )
+    {
+        return iMin;
+    }
+    if ( aQuantile >= 1.0f )
+    {
+        return iMax;
+    }
+
+    // Nearest rank, 1-based
+    const auto rank = static_cast< std::uint32_t >( aQuantile * ( iCount - 1 ) ) + 1;
+    std::uint32_t cumulative = 0;
+    std::size_t bucket = 0;
+    for ( ; bucket < KBucketNumber - 1; ++bucket )
+    {
+        cumulative += iBuckets[ bucket ];
+        if ( cumulative >= rank )
+        {
+            break;
+        }
+    }
+
+    const auto value = BucketMidpoint( bucket );
+    return static_cast< std::int16_t >( value < iMin ? iMin : value > iMax ? iMax : value );
+}
+
+CIna3221Statistics::CReport
+CIna3221Statistics::Report( std::int32_t aLsbUv ) const NOEXCEPT
+{
+    CReport report;
+    report.iCount = iCount;
+    report.iMinUv = static_cast< float >( iMin ) * aLsbUv;
+    report.iMaxUv = static_cast< float >( iMax ) * aLsbUv;
+    report.iMeanUv = static_cast< float >( iMean * aLsbUv );
+    report.iStdDevUv = static_cast< float >( StdDev( ) * aLsbUv );
+    report.iP50Uv = static_cast< float >( Quantile( 0.5f ) ) * aLsbUv;
+    report.iP99Uv = static_cast< float >( Quantile( 0.99f ) ) * aLsbUv;
+    return report;
+}
+
+std::size_t
+CIna3221Statistics::Bucket( std::int16_t aCounts ) NOEXCEPT
+{
+    // Negative values mirror the magnitude buckets below KMagnitudeBucketNumber, so bucket order
+    // follows value order
+    return aCounts >= 0 ? KMagnitudeBucketNumber + MagnitudeBucket( aCounts )
+                        : KMagnitudeBucketNumber - 1 - MagnitudeBucket( -( aCounts + 1 ) );
+}
+
+std::int32_t
+CIna3221Statistics::BucketMidpoint( std::size_t aBucket ) NOEXCEPT
+{
+    return aBucket >= KMagnitudeBucketNumber
+               ? MagnitudeBucketMidpoint( aBucket - KMagnitudeBucketNumber )
+               : -( MagnitudeBucketMidpoint( KMagnitudeBucketNumber - 1 - aBucket ) + 1 );
+}
+
+}  // namespace ExternalHardware
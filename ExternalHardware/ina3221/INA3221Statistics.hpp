@@ -0,0 +1,247 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <AbstractPlatform/common/Platform.hpp>
+#include <ExternalHardware/ina3221/INA3221.hpp>
+
+namespace ExternalHardware
+{
+// Constant-memory summary of a stream of signed register counts (see
+// CIina3221::VoltageRegisterToCounts): Welford mean/variance, min/max and a log-bucket quantile
+// sketch. Adding a sample is O(1) and allocation free. Summaries of the same quantity merge
+// exactly for count/min/max/moments and bucket-exactly for quantiles, so windows, channels and
+// devices can be combined.
+//
+// The sketch keeps magnitudes below KExactMagnitude exact and splits every octave above into
+// KSubBucketNumber buckets, a quantile is off by at most 1/16 of its magnitude.
+class CIna3221Statistics
+{
+public:
+    static constexpr std::int32_t KExactMagnitude = 16;
+    static constexpr std::int32_t KSubBucketNumber = 8;
+    // Exact buckets plus 11 octaves (16..32767) per sign, covering the whole int16 range
+    static constexpr std::size_t KMagnitudeBucketNumber = KExactMagnitude + 11 * KSubBucketNumber;
+    static constexpr std::size_t KBucketNumber = 2 * KMagnitudeBucketNumber;
+
+    // Dashboard view of a summary in µV, for the LSB of the summarized register
+    struct CReport
+    {
+        std::uint32_t iCount = 0;
+        float iMinUv = 0.0f;
+        float iMaxUv = 0.0f;
+        float iMeanUv = 0.0f;
+        float iStdDevUv = 0.0f;
+        float iP50Uv = 0.0f;
+        float iP99Uv = 0.0f;
+    };
+
+    void Reset( ) NOEXCEPT;
+
+    void Add( std::int16_t aCounts ) NOEXCEPT;
+
+    void Merge( const CIna3221Statistics& aOther ) NOEXCEPT;
+
+    inline std::uint32_t
+    Count( ) const NOEXCEPT
+    {
+        return iCount;
+    }
+
+    inline std::int16_t
+    Min( ) const NOEXCEPT
+    {
+        return iMin;
+    }
+
+    inline std::int16_t
+    Max( ) const NOEXCEPT
+    {
+        return iMax;
+    }
+
+    inline double
+    Mean( ) const NOEXCEPT
+    {
+        return iMean;
+    }
+
+    // Population variance in counts^2
+    inline double
+    Variance( ) const NOEXCEPT
+    {
+        return iCount != 0 ? iM2 / iCount : 0.0;
+    }
+
+    double StdDev( ) const NOEXCEPT;
+
+    // Sketch estimate of the aQuantile (0..1) quantile in counts, clamped to [Min, Max]
+    std::int16_t Quantile( float aQuantile ) const NOEXCEPT;
+
+    // aLsbUv: CIina3221::KShuntVoltageLsbUv or CIina3221::KBusVoltageLsbUv
+    CReport Report( std::int32_t aLsbUv ) const NOEXCEPT;
+
+private:
+    std::uint32_t iCount = 0;
+    std::int16_t iMin = 0;
+    std::int16_t iMax = 0;
+    double iMean = 0.0;
+    double iM2 = 0.0;  // Sum of squared deviations from the mean
+    std::uint32_t iBuckets[ KBucketNumber ] = { };
+
+    static std::size_t Bucket( std::int16_t aCounts ) NOEXCEPT;
+    static std::int32_t BucketMidpoint( std::size_t aBucket ) NOEXCEPT;
+};
+
+enum class Ina3221WindowMode : std::uint8_t
+{
+    Tumbling,  // Back-to-back windows, the last completed one is reported
+    Sliding,   // The last window of samples, advancing one pane at a time
+};
+
+// Windowed CIna3221Statistics. A window of aWindowSamples is split into taPaneNumber panes;
+// in sliding mode the reported window covers the current pane and the taPaneNumber - 1 panes
+// before it, so it moves in steps of one pane. Adding is O(1), Window is O(taPaneNumber).
+template < std::size_t taPaneNumber >
+class CIna3221WindowedStatistics
+{
+public:
+    static_assert( taPaneNumber > 0, "" );
+
+    explicit CIna3221WindowedStatistics( Ina3221WindowMode aMode = Ina3221WindowMode::Sliding,
+                                         std::uint32_t aWindowSamples = 1024 ) NOEXCEPT
+        : iMode{ aMode },
+          iPaneSamples{ aMode == Ina3221WindowMode::Tumbling
+                            ? aWindowSamples
+                            : static_cast< std::uint32_t >( ( aWindowSamples + taPaneNumber - 1 )
+                                                            / taPaneNumber ) }
+    {
+        if ( iPaneSamples == 0 )
+        {
+            iPaneSamples = 1;
+        }
+    }
+
+    void
+    Reset( ) NOEXCEPT
+    {
+        for ( auto& pane : iPanes )
+        {
+            pane.Reset( );
+        }
+        iCompleted.Reset( );
+        iPane = 0;
+    }
+
+    // Returns true when the sample completed a tumbling window or a sliding pane
+    bool
+    Add( std::int16_t aCounts ) NOEXCEPT
+    {
+        auto& pane = iPanes[ iPane ];
+        pane.Add( aCounts );
+        if ( pane.Count( ) < iPaneSamples )
+        {
+            return false;
+        }
+
+        if ( iMode == Ina3221WindowMode::Tumbling )
+        {
+            iCompleted = pane;
+            pane.Reset( );
+        }
+        else
+        {
+            iPane = ( iPane + 1 ) % taPaneNumber;
+            iPanes[ iPane ].Reset( );
+        }
+        return true;
+    }
+
+    CIna3221Statistics
+    Window( ) const NOEXCEPT
+    {
+        if ( iMode == Ina3221WindowMode::Tumbling )
+        {
+            return iCompleted;
+        }
+
+        CIna3221Statistics window;
+        for ( const auto& pane : iPanes )
+        {
+            window.Merge( pane );
+        }
+        return window;
+    }
+
+private:
+    const Ina3221WindowMode iMode;
+    std::uint32_t iPaneSamples;
+    std::size_t iPane = 0;
+    // Tumbling mode accumulates in the first pane only
+    CIna3221Statistics iPanes[ taPaneNumber ];
+    CIna3221Statistics iCompleted;
+};
+
+// Shunt and bus voltage windows of all channels of one device, fed with raw registers
+template < std::size_t taPaneNumber >
+class CIna3221ChannelStatistics
+{
+public:
+    using TWindow = CIna3221WindowedStatistics< taPaneNumber >;
+
+    explicit CIna3221ChannelStatistics( Ina3221WindowMode aMode = Ina3221WindowMode::Sliding,
+                                        std::uint32_t aWindowSamples = 1024 ) NOEXCEPT
+        : iShuntVoltage{ TWindow{ aMode, aWindowSamples }, TWindow{ aMode, aWindowSamples },
+                         TWindow{ aMode, aWindowSamples } },
+          iBusVoltage{ TWindow{ aMode, aWindowSamples }, TWindow{ aMode, aWindowSamples },
+                       TWindow{ aMode, aWindowSamples } }
+    {
+    }
+
+    void
+    Reset( ) NOEXCEPT
+    {
+        for ( std::uint8_t index = 0; index < CIina3221::KChannelNumber; ++index )
+        {
+            iShuntVoltage[ index ].Reset( );
+            iBusVoltage[ index ].Reset( );
+        }
+    }
+
+    void
+    Add( const std::uint16_t ( &aShuntVoltageRegister )[ CIina3221::KChannelNumber ],
+         const std::uint16_t ( &aBusVoltageRegister )[ CIina3221::KChannelNumber ] ) NOEXCEPT
+    {
+        for ( std::uint8_t index = 0; index < CIina3221::KChannelNumber; ++index )
+        {
+            iShuntVoltage[ index ].Add(
+                CIina3221::VoltageRegisterToCounts( aShuntVoltageRegister[ index ] ) );
+            iBusVoltage[ index ].Add(
+                CIina3221::VoltageRegisterToCounts( aBusVoltageRegister[ index ] ) );
+        }
+    }
+
+    inline void
+    Add( const CIina3221::CMeasurementSnapshot& aSnapshot ) NOEXCEPT
+    {
+        Add( aSnapshot.iShuntVoltageRegister, aSnapshot.iBusVoltageRegister );
+    }
+
+    inline const TWindow&
+    ShuntVoltage( std::uint8_t aChannel ) const NOEXCEPT
+    {
+        return iShuntVoltage[ aChannel - CIina3221::KChannel1 ];
+    }
+
+    inline const TWindow&
+    BusVoltage( std::uint8_t aChannel ) const NOEXCEPT
+    {
+        return iBusVoltage[ aChannel - CIina3221::KChannel1 ];
+    }
+
+private:
+    TWindow iShuntVoltage[ CIina3221::KChannelNumber ];
+    TWindow iBusVoltage[ CIina3221::KChannelNumber ];
+};
+
+}  // namespace ExternalHardware
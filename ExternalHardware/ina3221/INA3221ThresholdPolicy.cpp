@@ -0,0 +1,323 @@
+#include <ExternalHardware/ina3221/INA3221ThresholdPolicy.hpp>
+
+namespace ExternalHardware
+{
+namespace
+{
+using TRegisterMap = Ina3221::CRegisterMap;
+
+constexpr std::uint8_t KRegSumLimit = TRegisterMap::TShuntVoltageSumLimit::KAddress;
+constexpr std::uint8_t KRegMaskEnable = TRegisterMap::TMaskEnable::KAddress;
+constexpr std::uint8_t KRegPowerValidUpper = TRegisterMap::TPowerValidUpperLimit::KAddress;
+constexpr std::uint8_t KRegPowerValidLower = TRegisterMap::TPowerValidLowerLimit::KAddress;
+
+// Limits not set by the policy: full scale, which never alerts
+constexpr std::int32_t KDisabledShuntLimitUv = CIina3221::KMaxShuntVoltageUv;
+
+inline std::int32_t
+RoundToInt32( float aValue ) NOEXCEPT
+{
+    return static_cast< std::int32_t >( aValue >= 0.0f ? aValue + 0.5f : aValue - 0.5f );
+}
+
+// The sum limit holds its data in bits 15..1 with the shunt voltage LSB
+inline std::int32_t
+SumLimitRegisterToUv( std::uint16_t aRegisterValue ) NOEXCEPT
+{
+    return static_cast< std::int16_t >( aRegisterValue & 0xFFFE ) / 2
+           * CIina3221::KShuntVoltageLsbUv;
+}
+
+// Register encoding truncates towards zero, so readback may be up to one LSB off
+inline bool
+Matches( std::int32_t aReadbackUv, std::int32_t aExpectedUv, std::int32_t aLsbUv ) NOEXCEPT
+{
+    const auto difference = aReadbackUv - aExpectedUv;
+    return difference <= aLsbUv && difference >= -aLsbUv;
+}
+
+inline float
+MicroVoltsToVolts( std::int32_t aMicroVolts ) NOEXCEPT
+{
+    return static_cast< float >( aMicroVolts ) * 1e-6f;
+}
+
+}  // namespace
+
+CIna3221ThresholdPolicy::CIna3221ThresholdPolicy( CIina3221& aDevice ) NOEXCEPT
+    : iDevice{ aDevice },
+      iReadback{ aDevice }
+{
+}
+
+CIna3221ThresholdPolicy::TErrorCode
+CIna3221ThresholdPolicy::Apply( const CPolicy& aPolicy ) NOEXCEPT
+{
+    iFailedRegister = KNoRegister;
+
+    CCompiled compiled;
+    std::uint8_t hostMonitoredChannels = 0;
+    auto result = Compile( aPolicy, compiled, hostMonitoredChannels );
+    if ( result != AbstractPlatform::KOk )
+    {
+        return result;
+    }
+
+    CIina3221::CTransaction transaction{ iDevice };
+    for ( std::uint8_t channel = CIina3221::KChannel1; channel <= CIina3221::KChannelNumber;
+          ++channel )
+    {
+        const auto index = channel - CIina3221::KChannel1;
+        transaction
+            .SetShuntCriticalAlertLimit( MicroVoltsToVolts( compiled.iCriticalUv[ index ] ),
+                                         channel )
+            .SetShuntWarningAlertLimit( MicroVoltsToVolts( compiled.iWarningUv[ index ] ),
+                                        channel );
+    }
+    transaction.SetShuntVoltageSumLimit( MicroVoltsToVolts( compiled.iSumUv ) );
+    if ( compiled.iPowerValidLowerUv >= 0 )
+    {
+        transaction.SetPowerValidUpperLimit( MicroVoltsToVolts( compiled.iPowerValidUpperUv ) )
+            .SetPowerValidLowerLimit( MicroVoltsToVolts( compiled.iPowerValidLowerUv ) );
+    }
+    // Committed after the limits, so alerts never act on stale ones
+    transaction.SetMaskEnable( compiled.iMaskEnable );
+
+    result = transaction.Commit( );
+    if ( result != AbstractPlatform::KOk )
+    {
+        iApplied = false;
+        iFailedRegister = transaction.FailedRegister( );
+        return result;
+    }
+
+    iPolicy = aPolicy;
+    iCompiled = compiled;
+    iHostMonitoredChannels = hostMonitoredChannels;
+    iApplied = true;
+
+    // One block read covers every policy register
+    iReadback.Clear( );
+    for ( std::uint8_t channel = CIina3221::KChannel1; channel <= CIina3221::KChannelNumber;
+          ++channel )
+    {
+        iReadback.AddRegister( TRegisterMap::TCriticalAlertLimit::Address( channel ) )
+            .AddRegister( TRegisterMap::TWarningAlertLimit::Address( channel ) );
+    }
+    iReadback.AddRegister( KRegSumLimit ).AddMaskEnable( );
+    if ( iCompiled.iPowerValidLowerUv >= 0 )
+    {
+        iReadback.AddRegister( KRegPowerValidUpper ).AddRegister( KRegPowerValidLower );
+    }
+
+    return Verify( );
+}
+
+CIna3221ThresholdPolicy::TErrorCode
+CIna3221ThresholdPolicy::Verify( ) NOEXCEPT
+{
+    iFailedRegister = KNoRegister;
+    if ( !iApplied )
+    {
+        return AbstractPlatform::KGenericError;
+    }
+
+    const auto result = iReadback.Execute( );
+    if ( result != AbstractPlatform::KOk )
+    {
+        iFailedRegister = iReadback.FailedRegister( );
+        return result;
+    }
+
+    iFailedRegister = Mismatch( );
+    if ( iFailedRegister != KNoRegister )
+    {
+        // The shadow cache no longer matches the device, e.g. after a reset
+        iDevice.Invalidate( );
+        return AbstractPlatform::KGenericError;
+    }
+    return AbstractPlatform::KOk;
+}
+
+std::uint8_t
+CIna3221ThresholdPolicy::Mismatch( ) const NOEXCEPT
+{
+    for ( std::uint8_t channel = CIina3221::KChannel1; channel <= CIina3221::KChannelNumber;
+          ++channel )
+    {
+        const auto index = channel - CIina3221::KChannel1;
+        const auto criticalAddress = TRegisterMap::TCriticalAlertLimit::Address( channel );
+        if ( !Matches( CIina3221::ShuntRegisterToUv( iReadback.Value( criticalAddress ) ),
+                       iCompiled.iCriticalUv[ index ],
+                       CIina3221::KShuntVoltageLsbUv ) )
+        {
+            return criticalAddress;
+        }
+        const auto warningAddress = TRegisterMap::TWarningAlertLimit::Address( channel );
+        if ( !Matches( CIina3221::ShuntRegisterToUv( iReadback.Value( warningAddress ) ),
+                       iCompiled.iWarningUv[ index ],
+                       CIina3221::KShuntVoltageLsbUv ) )
+        {
+            return warningAddress;
+        }
+    }
+
+    if ( !Matches( SumLimitRegisterToUv( iReadback.Value( KRegSumLimit ) ),
+                   iCompiled.iSumUv,
+                   CIina3221::KShuntVoltageLsbUv ) )
+    {
+        return KRegSumLimit;
+    }
+
+    // Status flags change with every conversion, only the control bits belong to the policy
+    if ( ( iReadback.MaskEnable( ).Value( ) & CIina3221::CMaskEnable::KControlMask )
+         != iCompiled.iMaskEnable.Value( ) )
+    {
+        return KRegMaskEnable;
+    }
+
+    if ( iCompiled.iPowerValidLowerUv < 0 )
+    {
+        return KNoRegister;
+    }
+    if ( !Matches( CIina3221::BusRegisterToUv( iReadback.Value( KRegPowerValidUpper ) ),
+                   iCompiled.iPowerValidUpperUv,
+                   CIina3221::KBusVoltageLsbUv ) )
+    {
+        return KRegPowerValidUpper;
+    }
+    if ( !Matches( CIina3221::BusRegisterToUv( iReadback.Value( KRegPowerValidLower ) ),
+                   iCompiled.iPowerValidLowerUv,
+                   CIina3221::KBusVoltageLsbUv ) )
+    {
+        return KRegPowerValidLower;
+    }
+    return KNoRegister;
+}
+
+CIna3221ThresholdPolicy::TErrorCode
+CIna3221ThresholdPolicy::ShuntLimitUv( float aCurrent,
+                                       std::uint8_t aChannel,
+                                       std::int32_t& aMicroVolts ) const NOEXCEPT
+{
+    if ( aCurrent <= 0.0f )
+    {
+        aMicroVolts = KDisabledShuntLimitUv;
+        return AbstractPlatform::KOk;
+    }
+
+    // V[µV] = I[A] * R[µΩ]
+    const auto shuntVoltageUv
+        = aCurrent * static_cast< float >( iDevice.ShuntResistanceUOhm( aChannel ) );
+    if ( shuntVoltageUv <= 0.0f || shuntVoltageUv > CIina3221::KMaxShuntVoltageUv )
+    {
+        // No shunt resistance configured, or a limit the register cannot hold
+        return AbstractPlatform::KInvalidArgumentError;
+    }
+    aMicroVolts = RoundToInt32( shuntVoltageUv );
+    return AbstractPlatform::KOk;
+}
+
+CIna3221ThresholdPolicy::TErrorCode
+CIna3221ThresholdPolicy::Compile( const CPolicy& aPolicy,
+                                  CCompiled& aCompiled,
+                                  std::uint8_t& aHostMonitoredChannels ) const NOEXCEPT
+{
+    aHostMonitoredChannels = 0;
+    aCompiled.iMaskEnable = CIina3221::CMaskEnable{ 0 }
+                                .SetCriticalLatchEnable( aPolicy.iLatchCritical )
+                                .SetWarningLatchEnable( aPolicy.iLatchWarning );
+
+    std::int32_t underVoltageUv = -1;
+    bool sharedUnderVoltage = true;
+    for ( std::uint8_t channel = CIina3221::KChannel1; channel <= CIina3221::KChannelNumber;
+          ++channel )
+    {
+        const auto index = channel - CIina3221::KChannel1;
+        auto result = ShuntLimitUv(
+            aPolicy.iCriticalCurrentA[ index ], channel, aCompiled.iCriticalUv[ index ] );
+        if ( result == AbstractPlatform::KOk )
+        {
+            result = ShuntLimitUv(
+                aPolicy.iWarningCurrentA[ index ], channel, aCompiled.iWarningUv[ index ] );
+        }
+        if ( result != AbstractPlatform::KOk )
+        {
+            return result;
+        }
+
+        const auto channelUnderVoltageUv
+            = aPolicy.iUnderVoltageV[ index ] > 0.0f
+                  ? RoundToInt32( aPolicy.iUnderVoltageV[ index ] * 1e6f )
+                  : -1;
+        if ( channelUnderVoltageUv > CIina3221::KMaxBusVoltageUv )
+        {
+            return AbstractPlatform::KInvalidArgumentError;
+        }
+        if ( channelUnderVoltageUv >= 0 )
+        {
+            aHostMonitoredChannels |= CIina3221::ChannelMask( channel );
+        }
+        if ( index == 0 )
+        {
+            underVoltageUv = channelUnderVoltageUv;
+        }
+        else if ( channelUnderVoltageUv != underVoltageUv )
+        {
+            sharedUnderVoltage = false;
+        }
+    }
+
+    // Power-valid watches all bus voltages against one window
+    if ( sharedUnderVoltage && underVoltageUv >= 0 )
+    {
+        const auto upperUv
+            = underVoltageUv + RoundToInt32( aPolicy.iPowerValidHysteresisV * 1e6f );
+        if ( aPolicy.iPowerValidHysteresisV < 0.0f || upperUv > CIina3221::KMaxBusVoltageUv )
+        {
+            return AbstractPlatform::KInvalidArgumentError;
+        }
+        aCompiled.iPowerValidLowerUv = underVoltageUv;
+        aCompiled.iPowerValidUpperUv = upperUv;
+        aHostMonitoredChannels = 0;
+    }
+
+    aCompiled.iSumUv = KDisabledShuntLimitUv;
+    if ( aPolicy.iSumCurrentA > 0.0f )
+    {
+        std::uint32_t shuntResistanceUOhm = 0;
+        for ( std::uint8_t channel = CIina3221::KChannel1; channel <= CIina3221::KChannelNumber;
+              ++channel )
+        {
+            if ( ( aPolicy.iSumChannelMask & CIina3221::ChannelMask( channel ) ) == 0 )
+            {
+                continue;
+            }
+            const auto channelShuntResistanceUOhm = iDevice.ShuntResistanceUOhm( channel );
+            if ( channelShuntResistanceUOhm == 0
+                 || ( shuntResistanceUOhm != 0
+                      && channelShuntResistanceUOhm != shuntResistanceUOhm ) )
+            {
+                // Summed shunt voltages only scale to a current with equal, known shunts
+                return AbstractPlatform::KInvalidArgumentError;
+            }
+            shuntResistanceUOhm = channelShuntResistanceUOhm;
+            aCompiled.iMaskEnable.SetSummationChannel( channel, true );
+        }
+        if ( shuntResistanceUOhm == 0 )
+        {
+            return AbstractPlatform::KInvalidArgumentError;
+        }
+
+        const auto sumUv = aPolicy.iSumCurrentA * static_cast< float >( shuntResistanceUOhm );
+        if ( sumUv > CIina3221::KMaxShuntVoltageUv )
+        {
+            return AbstractPlatform::KInvalidArgumentError;
+        }
+        aCompiled.iSumUv = RoundToInt32( sumUv );
+    }
+
+    return AbstractPlatform::KOk;
+}
+
+}  // namespace ExternalHardware
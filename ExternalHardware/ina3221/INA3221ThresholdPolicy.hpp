@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <ExternalHardware/ina3221/INA3221.hpp>
+
+namespace ExternalHardware
+{
+// Compiles per-rail current and voltage limits into the alert registers of one CIina3221, so the
+// device checks them on every conversion and the host only handles alerts (see
+// CIna3221AlertEngine) plus a slow background poll.
+// - overcurrent limits become critical (each conversion) and warning (averaged) shunt voltage
+//   limits, using the shunt resistances configured on the device
+// - a total current limit becomes the summation limit and the SSCx bits of its channels, which
+//   need equal shunt resistances since the device sums shunt voltages
+// - undervoltage becomes the power-valid lower limit. Power-valid is one window over all bus
+//   voltages, so it is offloaded only when all channels share the same limit; otherwise the
+//   rails with a limit stay host monitored (HostMonitoredChannels).
+// Apply writes the registers as one CIina3221::CTransaction and reads them back.
+class CIna3221ThresholdPolicy
+{
+public:
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    struct CPolicy
+    {
+        constexpr CPolicy( ){ };
+
+        // Per channel, 0 disables the limit
+        float iCriticalCurrentA[ CIina3221::KChannelNumber ] = { };
+        float iWarningCurrentA[ CIina3221::KChannelNumber ] = { };
+        float iUnderVoltageV[ CIina3221::KChannelNumber ] = { };
+
+        float iPowerValidHysteresisV = 0.5f;  // Power-valid upper limit above the lower one
+
+        float iSumCurrentA = 0.0f;         // Total current of iSumChannelMask, 0 disables
+        std::uint8_t iSumChannelMask = 0;  // CIina3221::ChannelMask bits
+
+        bool iLatchCritical = false;  // CEN: critical and summation flags hold until read
+        bool iLatchWarning = false;   // WEN: warning flags hold until read
+
+        std::uint32_t iHostPollPeriodMs = 1;          // While any limit is host monitored
+        std::uint32_t iBackgroundPollPeriodMs = 500;  // Once the device watches every limit
+    };
+
+    static constexpr std::uint8_t KNoRegister = 0xFF;
+
+    explicit CIna3221ThresholdPolicy( CIina3221& aDevice ) NOEXCEPT;
+
+    // Validates aPolicy against the shunt resistances and register ranges (nothing is written
+    // on KInvalidArgumentError), commits it and verifies the registers. Limits not set in
+    // aPolicy are written as full scale, the power-valid limits are left alone unless offloaded.
+    TErrorCode Apply( const CPolicy& aPolicy ) NOEXCEPT;
+
+    // Reads the policy registers back from the device, bypassing the shadow cache, e.g. after a
+    // brown-out. A mismatch fails with KGenericError and invalidates the shadow cache, so the
+    // next Apply rewrites every register. Reading mask/enable clears latched flags.
+    TErrorCode Verify( ) NOEXCEPT;
+
+    inline const CPolicy&
+    Policy( ) const NOEXCEPT
+    {
+        return iPolicy;
+    }
+
+    // Channels with a limit the device does not watch (CIina3221::ChannelMask bits)
+    inline std::uint8_t
+    HostMonitoredChannels( ) const NOEXCEPT
+    {
+        return iHostMonitoredChannels;
+    }
+
+    inline std::uint32_t
+    PollPeriodMs( ) const NOEXCEPT
+    {
+        return iHostMonitoredChannels != 0 ? iPolicy.iHostPollPeriodMs
+                                           : iPolicy.iBackgroundPollPeriodMs;
+    }
+
+    // Register that failed the last Apply or Verify (write, read or mismatch), KNoRegister if
+    // none
+    inline std::uint8_t
+    FailedRegister( ) const NOEXCEPT
+    {
+        return iFailedRegister;
+    }
+
+private:
+    // Register limits in µV, power-valid -1 if not offloaded
+    struct CCompiled
+    {
+        std::int32_t iCriticalUv[ CIina3221::KChannelNumber ] = { };
+        std::int32_t iWarningUv[ CIina3221::KChannelNumber ] = { };
+        std::int32_t iSumUv = 0;
+        std::int32_t iPowerValidLowerUv = -1;
+        std::int32_t iPowerValidUpperUv = -1;
+        CIina3221::CMaskEnable iMaskEnable{ 0 };
+    };
+
+    CIina3221& iDevice;
+    CPolicy iPolicy;
+    CCompiled iCompiled;
+    CIina3221::CReadPlan iReadback;  // Registers of the applied policy
+    bool iApplied = false;
+    std::uint8_t iHostMonitoredChannels = 0;
+    std::uint8_t iFailedRegister = KNoRegister;
+
+    TErrorCode Compile( const CPolicy& aPolicy,
+                        CCompiled& aCompiled,
+                        std::uint8_t& aHostMonitoredChannels ) const NOEXCEPT;
+    std::uint8_t Mismatch( ) const NOEXCEPT;
+    TErrorCode ShuntLimitUv( float aCurrent,
+                             std::uint8_t aChannel,
+                             std::int32_t& aMicroVolts ) const NOEXCEPT;
+};
+
+}  // namespace ExternalHardware
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <AbstractPlatform/common/Platform.hpp>
+
+namespace ExternalHardware
+{
+// Wait-free single-producer/single-consumer ring buffer over caller-owned storage
+template < typename taValue >
+class CSpscRingBuffer
+{
+public:
+    CSpscRingBuffer( taValue* aStorage, std::size_t aCapacity ) NOEXCEPT
+        : iStorage{ aStorage },
+          iCapacity{ aCapacity }
+    {
+    }
+
+    CSpscRingBuffer( const CSpscRingBuffer& ) = delete;
+    CSpscRingBuffer& operator=( const CSpscRingBuffer& ) = delete;
+
+    // Producer side. Returns false if the buffer is full.
+    bool
+    TryPush( const taValue& aValue ) NOEXCEPT
+    {
+        const auto head = iHead.load( std::memory_order_relaxed );
+        if ( head - iTail.load( std::memory_order_acquire ) >= iCapacity )
+        {
+            return false;
+        }
+        iStorage[ head % iCapacity ] = aValue;
+        iHead.store( head + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Consumer side. Moves up to aMaxCount values into aValues, returns the number moved.
+    std::size_t
+    PopBatch( taValue* aValues, std::size_t aMaxCount ) NOEXCEPT
+    {
+        const auto tail = iTail.load( std::memory_order_relaxed );
+        const auto available = iHead.load( std::memory_order_acquire ) - tail;
+        const auto count = available < aMaxCount ? available : aMaxCount;
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            aValues[ i ] = iStorage[ ( tail + i ) % iCapacity ];
+        }
+        iTail.store( tail + count, std::memory_order_release );
+        return count;
+    }
+
+    std::size_t
+    Size( ) const NOEXCEPT
+    {
+        return iHead.load( std::memory_order_acquire ) - iTail.load( std::memory_order_acquire );
+    }
+
+    std::size_t
+    Capacity( ) const NOEXCEPT
+    {
+        return iCapacity;
+    }
+
+private:
+    static constexpr std::size_t KCacheLineSize = 64;
+
+    taValue* const iStorage;
+    const std::size_t iCapacity;
+
+    // Free-running counters, kept on separate cache lines to avoid false sharing
+    alignas( KCacheLineSize ) std::atomic< std::size_t > iHead{ 0 };
+    alignas( KCacheLineSize ) std::atomic< std::size_t > iTail{ 0 };
+};
+
+}  // namespace ExternalHardware
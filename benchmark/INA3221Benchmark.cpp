@@ -0,0 +1,1069 @@
+// INA3221 driver benchmark: register decode throughput, I2C transactions per driver operation,
+// end-to-end sample rate against a simulated bus with per-transaction latency and shared-device
+// throughput under concurrent reader threads.
+//
+// Usage: ina3221-benchmark [decode iterations] [end-to-end samples]
+// Prints one JSON document to stdout so results can be compared between driver versions. Host
+// checks of the decode results run first; any failure is reported on stderr and fails the run.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <ExternalHardware/ina3221/INA3221.hpp>
+#include <ExternalHardware/ina3221/INA3221Array.hpp>
+#include <ExternalHardware/ina3221/INA3221BulkDecoder.hpp>
+#include <ExternalHardware/ina3221/INA3221SharedDevice.hpp>
+#include <ExternalHardware/ina3221/INA3221Simulator.hpp>
+#include <ExternalHardware/ina3221/INA3221ThresholdPolicy.hpp>
+
+using namespace ExternalHardware;
+
+namespace
+{
+using TClock = std::chrono::steady_clock;
+
+constexpr std::uint32_t KDefaultDecodeIterations = 1u << 24;
+constexpr std::uint32_t KDefaultEndToEndSamples = 2000;
+constexpr std::uint32_t KTransactionRepetitions = 16;
+constexpr std::uint32_t KLatenciesNs[] = { 0, 20000, 100000, 500000 };
+constexpr std::uint32_t KReaderThreads[] = { 1, 2, 4, 8, 16 };
+constexpr std::chrono::milliseconds KSharedDeviceDuration{ 200 };
+
+// Keeps benchmark results observable so the loops are not optimized away
+volatile std::int64_t gSink = 0;
+
+std::uint32_t gCheckFailures = 0;
+
+using TDecoder = CIna3221BulkDecoder;
+
+const struct
+{
+    TDecoder::InstructionSet iInstructionSet;
+    const char* iName;
+} KInstructionSets[] = {
+    { TDecoder::InstructionSet::Scalar, "scalar" },
+    { TDecoder::InstructionSet::Sse2, "sse2" },
+    { TDecoder::InstructionSet::Avx2, "avx2" },
+    { TDecoder::InstructionSet::Neon, "neon" },
+};
+
+class CJsonWriter
+{
+public:
+    void
+    Begin( )
+    {
+        std::printf( "{\n  \"benchmark\": \"ina3221\",\n  \"format_version\": 1" );
+    }
+
+    void
+    End( )
+    {
+        std::printf( "\n}\n" );
+    }
+
+    void
+    BeginSection( const char* aName )
+    {
+        std::printf( ",\n  \"%s\": [", aName );
+        iEntryCount = 0;
+    }
+
+    void
+    EndSection( )
+    {
+        std::printf( "\n  ]" );
+    }
+
+    void
+    BeginEntry( const char* aName )
+    {
+        std::printf( "%s\n    { \"name\": \"%s\"", iEntryCount++ == 0 ? "" : ",", aName );
+    }
+
+    void
+    Field( const char* aName, double aValue )
+    {
+        std::printf( ", \"%s\": %.6g", aName, aValue );
+    }
+
+    void
+    Field( const char* aName, std::uint64_t aValue )
+    {
+        std::printf( ", \"%s\": %llu", aName, static_cast< unsigned long long >( aValue ) );
+    }
+
+    void
+    Field( const char* aName, const char* aValue )
+    {
+        std::printf( ", \"%s\": \"%s\"", aName, aValue );
+    }
+
+    void
+    EndEntry( )
+    {
+        std::printf( " }" );
+    }
+
+private:
+    std::uint32_t iEntryCount = 0;
+};
+
+template < typename taDecode >
+void
+BenchmarkDecode( CJsonWriter& aWriter,
+                 const char* aName,
+                 std::uint32_t aIterations,
+                 taDecode aDecode )
+{
+    std::int64_t accumulator = 0;
+    const auto start = TClock::now( );
+    for ( std::uint32_t iteration = 0; iteration < aIterations; ++iteration )
+    {
+        // Walks all register patterns, including the invalid low bits
+        accumulator += aDecode( static_cast< std::uint16_t >( iteration * 0x9E37u ) );
+    }
+    const auto elapsed = std::chrono::duration< double, std::nano >( TClock::now( ) - start );
+    gSink = gSink + accumulator;
+
+    aWriter.BeginEntry( aName );
+    aWriter.Field( "iterations", static_cast< std::uint64_t >( aIterations ) );
+    aWriter.Field( "ns_per_op", elapsed.count( ) / aIterations );
+    aWriter.Field( "mops_per_s", aIterations / elapsed.count( ) * 1e3 );
+    aWriter.EndEntry( );
+}
+
+void
+RunDecodeBenchmarks( CJsonWriter& aWriter, std::uint32_t aIterations )
+{
+    aWriter.BeginSection( "decode" );
+
+    BenchmarkDecode( aWriter, "shunt_register_to_uv", aIterations, []( std::uint16_t aValue ) {
+        return static_cast< std::int64_t >( CIina3221::ShuntRegisterToUv( aValue ) );
+    } );
+    BenchmarkDecode( aWriter, "bus_register_to_uv", aIterations, []( std::uint16_t aValue ) {
+        return static_cast< std::int64_t >( CIina3221::BusRegisterToUv( aValue ) );
+    } );
+    BenchmarkDecode( aWriter,
+                     "voltage_register_to_counts",
+                     aIterations,
+                     []( std::uint16_t aValue ) {
+                         return static_cast< std::int64_t >(
+                             CIina3221::VoltageRegisterToCounts( aValue ) );
+                     } );
+    // Driver float decode, the cost of the float API over the microvolt path
+    BenchmarkDecode( aWriter, "shunt_register_to_volts", aIterations, []( std::uint16_t aValue ) {
+        return static_cast< std::int64_t >( CIina3221::ShuntRegisterToVolts( aValue ) * 1e6f );
+    } );
+    BenchmarkDecode( aWriter, "bus_register_to_volts", aIterations, []( std::uint16_t aValue ) {
+        return static_cast< std::int64_t >( CIina3221::BusRegisterToVolts( aValue ) * 1e3f );
+    } );
+
+    BenchmarkDecode( aWriter, "config_unpack", aIterations, []( std::uint16_t aValue ) {
+        const CIina3221::CConfig config{ aValue };
+        return static_cast< std::int64_t >( config.GetOperationMode( ) )
+               + static_cast< std::int64_t >( config.GetShuntVoltageConversionTime( ) )
+               + static_cast< std::int64_t >( config.GetBusVoltageConversionTime( ) )
+               + static_cast< std::int64_t >( config.GetAveragingMode( ) )
+               + config.GetChannelEnable( CIina3221::KChannel1 )
+               + config.GetChannelEnable( CIina3221::KChannel2 )
+               + config.GetChannelEnable( CIina3221::KChannel3 );
+    } );
+    BenchmarkDecode( aWriter, "config_pack", aIterations, []( std::uint16_t aValue ) {
+        CIina3221::CConfig config;
+        config.SetOperationMode( static_cast< CIina3221::OperationMode >( aValue & 0x7 ) )
+            .SetShuntVoltageConversionTime(
+                static_cast< CIina3221::ConversionTime >( ( aValue >> 3 ) & 0x7 ) )
+            .SetBusVoltageConversionTime(
+                static_cast< CIina3221::ConversionTime >( ( aValue >> 6 ) & 0x7 ) )
+            .SetAveragingMode( static_cast< CIina3221::AveragingMode >( ( aValue >> 9 ) & 0x7 ) )
+            .SetChannelEnable( CIina3221::KChannel1, ( aValue & 0x1000 ) != 0 )
+            .SetChannelEnable( CIina3221::KChannel2, ( aValue & 0x2000 ) != 0 )
+            .SetChannelEnable( CIina3221::KChannel3, ( aValue & 0x4000 ) != 0 );
+        return static_cast< std::int64_t >( config.Value( ) );
+    } );
+    BenchmarkDecode( aWriter, "mask_enable_unpack", aIterations, []( std::uint16_t aValue ) {
+        const CIina3221::CMaskEnable maskEnable{ aValue };
+        std::int64_t flags = maskEnable.GetConversionReady( ) + maskEnable.GetTimingControl( )
+                             + maskEnable.GetPowerValid( ) + maskEnable.GetSummationAlert( );
+        for ( std::uint8_t channel = CIina3221::KChannel1; channel <= CIina3221::KChannel3;
+              ++channel )
+        {
+            flags += maskEnable.GetWarningAlert( channel ) + maskEnable.GetCriticalAlert( channel );
+        }
+        return flags;
+    } );
+    BenchmarkDecode( aWriter, "mask_enable_pack", aIterations, []( std::uint16_t aValue ) {
+        CIina3221::CMaskEnable maskEnable;
+        maskEnable.SetCriticalLatchEnable( ( aValue & 0x1 ) != 0 )
+            .SetWarningLatchEnable( ( aValue & 0x2 ) != 0 )
+            .SetSummationChannel( CIina3221::KChannel1, ( aValue & 0x4 ) != 0 )
+            .SetSummationChannel( CIina3221::KChannel2, ( aValue & 0x8 ) != 0 )
+            .SetSummationChannel( CIina3221::KChannel3, ( aValue & 0x10 ) != 0 );
+        return static_cast< std::int64_t >( maskEnable.Value( ) );
+    } );
+
+    aWriter.EndSection( );
+}
+
+template < typename taDecode >
+void
+BenchmarkBulkDecode( CJsonWriter& aWriter,
+                     const char* aName,
+                     const char* aInstructionSet,
+                     std::uint32_t aIterations,
+                     std::uint32_t aBlockSize,
+                     taDecode aDecode )
+{
+    const std::uint32_t blocks = ( aIterations + aBlockSize - 1 ) / aBlockSize;
+    const auto start = TClock::now( );
+    for ( std::uint32_t block = 0; block < blocks; ++block )
+    {
+        aDecode( );
+    }
+    const auto elapsed = std::chrono::duration< double, std::nano >( TClock::now( ) - start );
+    const double values = static_cast< double >( blocks ) * aBlockSize;
+
+    aWriter.BeginEntry( aName );
+    aWriter.Field( "instruction_set", aInstructionSet );
+    aWriter.Field( "iterations", static_cast< std::uint64_t >( values ) );
+    aWriter.Field( "ns_per_op", elapsed.count( ) / values );
+    aWriter.Field( "mops_per_s", values / elapsed.count( ) * 1e3 );
+    aWriter.EndEntry( );
+}
+
+void
+RunBulkDecodeBenchmarks( CJsonWriter& aWriter, std::uint32_t aIterations )
+{
+    aWriter.BeginSection( "bulk_decode" );
+
+    constexpr std::uint32_t KBlockSize = 4096;
+    static std::uint16_t registers[ KBlockSize ];
+    static std::int32_t microVolts[ KBlockSize ];
+    static float volts[ KBlockSize ];
+    for ( std::uint32_t index = 0; index < KBlockSize; ++index )
+    {
+        registers[ index ] = static_cast< std::uint16_t >( index * 0x9E37u );
+    }
+
+    const auto detected = TDecoder::ActiveInstructionSet( );
+    for ( const auto& instructionSet : KInstructionSets )
+    {
+        if ( !TDecoder::IsSupported( instructionSet.iInstructionSet ) )
+        {
+            continue;
+        }
+        TDecoder::SelectInstructionSet( instructionSet.iInstructionSet );
+
+        BenchmarkBulkDecode(
+            aWriter, "bulk_micro_volts", instructionSet.iName, aIterations, KBlockSize, [ & ]( ) {
+                TDecoder::DecodeMicroVolts(
+                    registers, KBlockSize, TDecoder::RegisterKind::MeasurementBlock, microVolts );
+                gSink = gSink + microVolts[ 0 ];
+            } );
+        BenchmarkBulkDecode(
+            aWriter, "bulk_volts", instructionSet.iName, aIterations, KBlockSize, [ & ]( ) {
+                TDecoder::DecodeVolts(
+                    registers, KBlockSize, TDecoder::RegisterKind::MeasurementBlock, volts );
+                gSink = gSink + static_cast< std::int64_t >( volts[ 1 ] );
+            } );
+    }
+    TDecoder::SelectInstructionSet( detected );
+
+    aWriter.EndSection( );
+}
+
+CIina3221::CConfig
+FastConfig( )
+{
+    return CIina3221::CConfig{ }
+        .SetShuntVoltageConversionTime( CIina3221::ConversionTime::t140us )
+        .SetBusVoltageConversionTime( CIina3221::ConversionTime::t140us )
+        .SetAveragingMode( CIina3221::AveragingMode::avg1 );
+}
+
+void
+Check( CJsonWriter& aWriter, const char* aName, bool aPassed )
+{
+    if ( !aPassed )
+    {
+        ++gCheckFailures;
+        std::fprintf( stderr, "check failed: %s\n", aName );
+    }
+    aWriter.BeginEntry( aName );
+    aWriter.Field( "passed", aPassed ? "true" : "false" );
+    aWriter.EndEntry( );
+}
+
+// Polls until a conversion with the current simulator inputs has completed
+bool
+WaitForFreshSnapshot( CIina3221& aDevice )
+{
+    CIina3221::CMeasurementSnapshot snapshot;
+    for ( std::uint32_t poll = 0; poll < 1000; ++poll )
+    {
+        if ( aDevice.ReadSnapshotIfReady( snapshot ) != AbstractPlatform::KOk )
+        {
+            return false;
+        }
+        if ( snapshot.iFresh )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline float
+MicroVoltsToVolts( std::int32_t aMicroVolts )
+{
+    return static_cast< float >( aMicroVolts ) * CIina3221::KVoltsPerMicroVolt;
+}
+
+// Conversion-ready line of a simulated device, as a GPIO-backed callback would report it
+struct CReadyLine
+{
+    const CIna3221Simulator* iSimulator;
+    std::uint64_t iConversions;  // Count at the trigger
+    bool iNever;                 // Stuck line
+};
+
+bool
+ReadyLine( void* aContext )
+{
+    const auto& line = *static_cast< const CReadyLine* >( aContext );
+    return !line.iNever && line.iSimulator->ConversionCount( ) > line.iConversions;
+}
+
+// Sleeps in virtual bus time
+void
+SleepOnBus( void* aContext, std::uint32_t aMicroseconds )
+{
+    static_cast< CSimulatedI2CBus* >( aContext )->Advance( std::uint64_t{ aMicroseconds } * 1000 );
+}
+
+// TriggerAndRead with a conversion-ready callback, which is paced by the delay callback
+void
+CheckTriggerWithReadyCallback( CJsonWriter& aWriter )
+{
+    CSimulatedI2CBus bus;
+    CIna3221Simulator simulator;
+    bus.Attach( simulator );
+    simulator.SetShuntVoltage( CIina3221::KChannel1, 0.02f );
+
+    CIina3221 device{ bus };
+    CReadyLine line{ &simulator, 0, false };
+    device.SetConversionReadyCallback( ReadyLine, &line );
+    CIina3221::CMeasurementSnapshot snapshot;
+    const bool ready = device.Init( CIina3221::CConfig{ } ) == AbstractPlatform::KOk;
+
+    // Unpaced callback polls would run out long before the conversion completes
+    Check( aWriter,
+           "trigger_ready_callback_requires_delay",
+           ready
+               && device.TriggerAndRead( CIina3221::KAllChannels, snapshot )
+                      == AbstractPlatform::KInvalidArgumentError );
+
+    device.SetDelayCallback( SleepOnBus, &bus );
+    line.iConversions = simulator.ConversionCount( );
+    Check( aWriter,
+           "trigger_ready_callback",
+           ready
+               && device.TriggerAndRead( CIina3221::KAllChannels, snapshot )
+                      == AbstractPlatform::KOk
+               && snapshot.iFresh
+               && CIina3221::ShuntRegisterToUv( snapshot.iShuntVoltageRegister[ 0 ] ) == 20000 );
+
+    // Times out no earlier than twice the conversion time after the trigger
+    line.iNever = true;
+    const auto startNs = bus.NowNs( );
+    Check( aWriter,
+           "trigger_ready_callback_timeout",
+           ready
+               && device.TriggerAndRead( CIina3221::KAllChannels, snapshot )
+                      == AbstractPlatform::KTimeoutError
+               && bus.NowNs( ) - startNs
+                      >= 2000ull * CIina3221::ConversionPeriodUs( CIina3221::CConfig{ } ) );
+}
+
+// Probing must leave latched alert flags and CVRF to the driver that owns the device
+void
+CheckProbe( CJsonWriter& aWriter )
+{
+    CSimulatedI2CBus bus;
+    CIna3221Simulator simulator;
+    bus.Attach( simulator );
+    simulator.SetShuntVoltage( CIina3221::KChannel1, 0.05f );
+
+    // Writing mask/enable last leaves the register pointer on it
+    CIina3221 device{ bus };
+    const bool ready
+        = device.Init( FastConfig( ) ) == AbstractPlatform::KOk
+          && device.SetShuntCriticalAlertLimit( 0.01f, CIina3221::KChannel1 )
+                 == AbstractPlatform::KOk
+          && device.SetMaskEnable( CIina3221::CMaskEnable{ }.SetCriticalLatchEnable( true ) )
+                 == AbstractPlatform::KOk;
+    bus.Advance( 2000ull * CIina3221::ConversionPeriodUs( FastConfig( ) ) );
+
+    constexpr std::uint8_t KRegMaskEnable = Ina3221::CRegisterMap::TMaskEnable::KAddress;
+    constexpr std::uint16_t KFlags
+        = CIina3221::CMaskEnable::TCF1::KMask | CIina3221::CMaskEnable::TCVRF::KMask;
+    const auto flags = simulator.Register( KRegMaskEnable );
+    Check( aWriter,
+           "probe_keeps_latched_flags",
+           ready && ( flags & KFlags ) == KFlags && CIna3221Array::Probe( bus, 0x01 ) == 0x01
+               && simulator.Register( KRegMaskEnable ) == flags );
+}
+
+// Bulk decoder output for every 16-bit register value, register i holds value i in wire order
+constexpr TDecoder::RegisterKind KRegisterKinds[] = {
+    TDecoder::RegisterKind::ShuntVoltage,
+    TDecoder::RegisterKind::BusVoltage,
+    TDecoder::RegisterKind::MeasurementBlock,
+};
+
+struct CBulkDecodeOutput
+{
+    static constexpr std::size_t KCount = 0x10000;
+    static constexpr std::size_t KKindNumber
+        = sizeof( KRegisterKinds ) / sizeof( KRegisterKinds[ 0 ] );
+
+    std::vector< std::int16_t > iCounts = std::vector< std::int16_t >( KCount );
+    std::vector< std::int32_t > iMicroVolts = std::vector< std::int32_t >( KCount * KKindNumber );
+    std::vector< float > iVolts = std::vector< float >( KCount * KKindNumber );
+};
+
+// Decodes every register word with aInstructionSet, once in a single call and once in chunks of
+// 1, 3, 7, ... words so that unaligned starts and every tail length are covered too. Chunked
+// results go to a second buffer, a measurement block restarts with channel 1 at each chunk.
+void
+BulkDecode( TDecoder::InstructionSet aInstructionSet, CBulkDecodeOutput ( &aOutput )[ 2 ] )
+{
+    constexpr std::size_t KCount = CBulkDecodeOutput::KCount;
+    std::vector< std::uint16_t > registers( KCount );
+    for ( std::size_t index = 0; index < KCount; ++index )
+    {
+        const std::uint8_t wire[] = { static_cast< std::uint8_t >( index >> 8 ),
+                                      static_cast< std::uint8_t >( index ) };
+        std::memcpy( &registers[ index ], wire, sizeof( wire ) );
+    }
+
+    TDecoder::SelectInstructionSet( aInstructionSet );
+    for ( std::size_t pass = 0; pass < 2; ++pass )
+    {
+        auto& output = aOutput[ pass ];
+        std::size_t chunk = pass == 0 ? KCount : 1;
+        for ( std::size_t offset = 0; offset < KCount; offset += chunk, chunk = chunk * 2 + 1 )
+        {
+            const std::size_t count = chunk < KCount - offset ? chunk : KCount - offset;
+            TDecoder::DecodeCounts( &registers[ offset ], count, &output.iCounts[ offset ] );
+            for ( std::size_t kind = 0; kind < CBulkDecodeOutput::KKindNumber; ++kind )
+            {
+                TDecoder::DecodeMicroVolts( &registers[ offset ],
+                                            count,
+                                            KRegisterKinds[ kind ],
+                                            &output.iMicroVolts[ kind * KCount + offset ] );
+                TDecoder::DecodeVolts( &registers[ offset ],
+                                       count,
+                                       KRegisterKinds[ kind ],
+                                       &output.iVolts[ kind * KCount + offset ] );
+            }
+        }
+    }
+}
+
+template < typename taValue >
+bool
+BitEqual( const std::vector< taValue >& aLeft, const std::vector< taValue >& aRight )
+{
+    return aLeft.size( ) == aRight.size( )
+           && std::memcmp( aLeft.data( ), aRight.data( ), aLeft.size( ) * sizeof( taValue ) ) == 0;
+}
+
+// Every vector instruction set must match the scalar decode bit for bit
+void
+CheckBulkDecoder( CJsonWriter& aWriter )
+{
+    static CBulkDecodeOutput scalar[ 2 ];
+    static CBulkDecodeOutput vector[ 2 ];
+
+    const auto detected = TDecoder::ActiveInstructionSet( );
+    BulkDecode( TDecoder::InstructionSet::Scalar, scalar );
+
+    // The scalar path itself against the driver decode
+    constexpr std::size_t KCount = CBulkDecodeOutput::KCount;
+    const auto& output = scalar[ 0 ];
+    bool scalarMatchesDriver = true;
+    for ( std::size_t index = 0; index < KCount; ++index )
+    {
+        const auto value = static_cast< std::uint16_t >( index );
+        const float shunt = CIina3221::ShuntRegisterToVolts( value );
+        const float bus = CIina3221::BusRegisterToVolts( value );
+        scalarMatchesDriver
+            = scalarMatchesDriver
+              && output.iCounts[ index ] == CIina3221::VoltageRegisterToCounts( value )
+              && output.iMicroVolts[ index ] == CIina3221::ShuntRegisterToUv( value )
+              && output.iMicroVolts[ KCount + index ] == CIina3221::BusRegisterToUv( value )
+              && std::memcmp( &output.iVolts[ index ], &shunt, sizeof( shunt ) ) == 0
+              && std::memcmp( &output.iVolts[ KCount + index ], &bus, sizeof( bus ) ) == 0;
+    }
+    Check( aWriter, "bulk_decode_scalar", scalarMatchesDriver );
+
+    for ( const auto& instructionSet : KInstructionSets )
+    {
+        if ( instructionSet.iInstructionSet == TDecoder::InstructionSet::Scalar
+             || !TDecoder::IsSupported( instructionSet.iInstructionSet ) )
+        {
+            continue;
+        }
+        BulkDecode( instructionSet.iInstructionSet, vector );
+
+        bool matches = true;
+        for ( std::size_t pass = 0; pass < 2; ++pass )
+        {
+            matches = matches && BitEqual( vector[ pass ].iCounts, scalar[ pass ].iCounts )
+                      && BitEqual( vector[ pass ].iMicroVolts, scalar[ pass ].iMicroVolts )
+                      && BitEqual( vector[ pass ].iVolts, scalar[ pass ].iVolts );
+        }
+        char name[ 32 ];
+        std::snprintf( name, sizeof( name ), "bulk_decode_%s", instructionSet.iName );
+        Check( aWriter, name, matches );
+    }
+    TDecoder::SelectInstructionSet( detected );
+}
+
+void
+RunChecks( CJsonWriter& aWriter )
+{
+    aWriter.BeginSection( "checks" );
+
+    // Two's complement data in bits 15..3
+    Check( aWriter,
+           "negative_register_decode",
+           CIina3221::ShuntRegisterToUv( 0xFFF8 ) == -40
+               && CIina3221::ShuntRegisterToUv( 0x8008 ) == -CIina3221::KMaxShuntVoltageUv
+               && CIina3221::BusRegisterToUv( 0xFFF8 ) == -8000
+               && CIina3221::ShuntRegisterToVolts( 0xFFF8 ) == MicroVoltsToVolts( -40 ) );
+
+    CSimulatedI2CBus bus;
+    CIna3221Simulator simulator;
+    bus.Attach( simulator );
+    simulator.SetShuntVoltage( CIina3221::KChannel1, -0.04f );
+    simulator.SetShuntVoltage( CIina3221::KChannel2, 0.1f );
+
+    CIina3221 device{ bus };
+    const auto summation = CIina3221::CMaskEnable{ }
+                               .SetSummationChannel( CIina3221::KChannel1, true )
+                               .SetSummationChannel( CIina3221::KChannel2, true );
+    const bool ready = device.Init( FastConfig( ) ) == AbstractPlatform::KOk
+                       && device.SetMaskEnable( summation ) == AbstractPlatform::KOk
+                       && WaitForFreshSnapshot( device ) && WaitForFreshSnapshot( device );
+
+    std::int32_t shuntMicroVolts = 0;
+    float shuntVoltage = 0.0f;
+    Check( aWriter,
+           "negative_shunt_voltage_read",
+           ready && device.ShuntVoltageUv( shuntMicroVolts ) == AbstractPlatform::KOk
+               && device.ShuntVoltageV( shuntVoltage ) == AbstractPlatform::KOk
+               && shuntMicroVolts == -40000 && shuntVoltage == MicroVoltsToVolts( -40000 ) );
+
+    // Sum registers hold the 40 µV counts in bits 14..1
+    constexpr std::uint8_t KRegSum = Ina3221::CRegisterMap::TShuntVoltageSum::KAddress;
+    constexpr std::uint8_t KRegSumLimit = Ina3221::CRegisterMap::TShuntVoltageSumLimit::KAddress;
+    float shuntSum = 0.0f;
+    Check( aWriter,
+           "shunt_voltage_sum",
+           ready && device.GetShuntVoltageSum( shuntSum ) == AbstractPlatform::KOk
+               && simulator.Register( KRegSum ) == ( 1500 << 1 )
+               && shuntSum == MicroVoltsToVolts( 60000 ) );
+
+    float shuntSumLimit = 0.0f;
+    Check( aWriter,
+           "shunt_voltage_sum_limit",
+           device.SetShuntVoltageSumLimit( 0.1f ) == AbstractPlatform::KOk
+               && simulator.Register( KRegSumLimit ) == ( 2500 << 1 )
+               && device.GetShuntVoltageSumLimit( shuntSumLimit ) == AbstractPlatform::KOk
+               && shuntSumLimit == MicroVoltsToVolts( 100000 ) );
+
+    // 10 µΩ: both shunt voltages exceed the std::int32_t microamp range
+    std::int32_t negativeMicroAmps = 0;
+    std::int32_t positiveMicroAmps = 0;
+    Check( aWriter,
+           "shunt_current_saturation",
+           ready
+               && device.SetShuntResistanceUOhm( 10, CIina3221::KChannel1 )
+                      == AbstractPlatform::KOk
+               && device.SetShuntResistanceUOhm( 10, CIina3221::KChannel2 )
+                      == AbstractPlatform::KOk
+               && device.CurrentUa( negativeMicroAmps, CIina3221::KChannel1 )
+                      == AbstractPlatform::KOk
+               && device.CurrentUa( positiveMicroAmps, CIina3221::KChannel2 )
+                      == AbstractPlatform::KOk
+               && negativeMicroAmps == std::numeric_limits< std::int32_t >::min( )
+               && positiveMicroAmps == std::numeric_limits< std::int32_t >::max( ) );
+
+    CheckTriggerWithReadyCallback( aWriter );
+    CheckProbe( aWriter );
+    CheckBulkDecoder( aWriter );
+
+    aWriter.EndSection( );
+}
+
+template < typename taOperation >
+void
+BenchmarkTransactions( CJsonWriter& aWriter,
+                       const char* aName,
+                       CSimulatedI2CBus& aBus,
+                       taOperation aOperation )
+{
+    std::uint64_t failures = 0;
+    aBus.ResetStatistics( );
+    const auto startNs = aBus.NowNs( );
+    for ( std::uint32_t repetition = 0; repetition < KTransactionRepetitions; ++repetition )
+    {
+        if ( aOperation( repetition ) != AbstractPlatform::KOk )
+        {
+            ++failures;
+        }
+    }
+    const auto& statistics = aBus.Statistics( );
+
+    aWriter.BeginEntry( aName );
+    aWriter.Field( "transactions_per_op",
+                   static_cast< double >( statistics.iTransactions ) / KTransactionRepetitions );
+    aWriter.Field( "reads_per_op",
+                   static_cast< double >( statistics.iReadTransactions )
+                       / KTransactionRepetitions );
+    aWriter.Field( "writes_per_op",
+                   static_cast< double >( statistics.iWriteTransactions )
+                       / KTransactionRepetitions );
+    aWriter.Field( "bytes_per_op",
+                   static_cast< double >( statistics.iBytes ) / KTransactionRepetitions );
+    aWriter.Field( "bus_us_per_op",
+                   static_cast< double >( aBus.NowNs( ) - startNs ) / KTransactionRepetitions
+                       / 1e3 );
+    aWriter.Field( "failures", failures );
+    aWriter.EndEntry( );
+}
+
+void
+RunTransactionBenchmarks( CJsonWriter& aWriter )
+{
+    CSimulatedI2CBus bus;
+    CIna3221Simulator simulator;
+    bus.Attach( simulator );
+    simulator.SetShuntVoltage( CIina3221::KChannel1, 0.01f );
+    simulator.SetBusVoltage( CIina3221::KChannel1, 12.0f );
+
+    CIina3221 device{ bus };
+    CIina3221::CMeasurementSnapshot snapshot;
+    CIina3221::CChannelPower channelPower;
+    device.SetShuntResistance( 0.1f, CIina3221::KChannel1 );
+
+    aWriter.BeginSection( "transactions" );
+
+    BenchmarkTransactions( aWriter, "init", bus, [ & ]( std::uint32_t ) {
+        return device.Init( FastConfig( ) );
+    } );
+
+    BenchmarkTransactions( aWriter, "init_warm_start", bus, [ & ]( std::uint32_t ) {
+        return device.Init( FastConfig( ), CIina3221::InitMode::WarmStart );
+    } );
+
+    BenchmarkTransactions( aWriter, "probe_all_addresses", bus, [ & ]( std::uint32_t ) {
+        return CIna3221Array::Probe( bus ) != 0 ? AbstractPlatform::KOk
+                                                : AbstractPlatform::KGenericError;
+    } );
+
+    // Process restart until the first valid snapshot: a reset clears the measurement registers
+    // until the next conversion completes, a warm start keeps them
+    BenchmarkTransactions( aWriter, "restart_to_valid_snapshot_cold", bus, [ & ]( std::uint32_t ) {
+        auto result = device.Init( FastConfig( ) );
+        for ( std::uint32_t poll = 0; poll < 1000 && result == AbstractPlatform::KOk; ++poll )
+        {
+            result = device.ReadSnapshotIfReady( snapshot );
+            if ( snapshot.iFresh )
+            {
+                break;
+            }
+        }
+        return result;
+    } );
+
+    BenchmarkTransactions( aWriter, "restart_to_valid_snapshot_warm", bus, [ & ]( std::uint32_t ) {
+        auto result = device.Init( FastConfig( ), CIina3221::InitMode::WarmStart );
+        if ( result == AbstractPlatform::KOk )
+        {
+            result = device.ReadSnapshot( snapshot );
+        }
+        return result;
+    } );
+
+    BenchmarkTransactions( aWriter, "channel_sweep_per_register", bus, [ & ]( std::uint32_t ) {
+        float voltage = 0.0f;
+        for ( std::uint8_t channel = CIina3221::KChannel1; channel <= CIina3221::KChannel3;
+              ++channel )
+        {
+            const auto shuntResult = device.ShuntVoltageV( voltage, channel );
+            if ( shuntResult != AbstractPlatform::KOk )
+            {
+                return shuntResult;
+            }
+            const auto busResult = device.BusVoltageV( voltage, channel );
+            if ( busResult != AbstractPlatform::KOk )
+            {
+                return busResult;
+            }
+        }
+        return AbstractPlatform::KOk;
+    } );
+
+    device.iSnapshotReadMode = CIina3221::SnapshotReadMode::Block;
+    BenchmarkTransactions( aWriter, "channel_sweep_snapshot_block", bus, [ & ]( std::uint32_t ) {
+        return device.ReadSnapshot( snapshot );
+    } );
+
+    device.iSnapshotReadMode = CIina3221::SnapshotReadMode::Sequential;
+    BenchmarkTransactions( aWriter,
+                           "channel_sweep_snapshot_sequential",
+                           bus,
+                           [ & ]( std::uint32_t ) { return device.ReadSnapshot( snapshot ); } );
+    device.iSnapshotReadMode = CIina3221::SnapshotReadMode::Block;
+
+    BenchmarkTransactions( aWriter, "snapshot_if_ready", bus, [ & ]( std::uint32_t ) {
+        return device.ReadSnapshotIfReady( snapshot );
+    } );
+
+    BenchmarkTransactions( aWriter, "read_channel_power", bus, [ & ]( std::uint32_t ) {
+        return device.ReadChannelPower( channelPower, CIina3221::KChannel1 );
+    } );
+
+    // Mixed telemetry set: bus and shunt voltage of channel 2, mask/enable and the shunt sum
+    BenchmarkTransactions( aWriter, "telemetry_set_per_register", bus, [ & ]( std::uint32_t ) {
+        float voltage = 0.0f;
+        CIina3221::CMaskEnable maskEnable;
+        auto result = device.BusVoltageV( voltage, CIina3221::KChannel2 );
+        if ( result == AbstractPlatform::KOk )
+        {
+            result = device.GetMaskEnable( maskEnable );
+        }
+        if ( result == AbstractPlatform::KOk )
+        {
+            result = device.ShuntVoltageV( voltage, CIina3221::KChannel2 );
+        }
+        if ( result == AbstractPlatform::KOk )
+        {
+            result = device.GetShuntVoltageSum( voltage );
+        }
+        return result;
+    } );
+
+    CIina3221::CReadPlan readPlan{ device };
+    readPlan.AddBusVoltage( CIina3221::KChannel2 )
+        .AddMaskEnable( )
+        .AddShuntVoltage( CIina3221::KChannel2 )
+        .AddShuntVoltageSum( );
+    BenchmarkTransactions( aWriter, "telemetry_set_read_plan", bus, [ & ]( std::uint32_t ) {
+        return readPlan.Execute( );
+    } );
+
+    // Overcurrent limits on channel 1 and a shared undervoltage limit, written and read back
+    CIna3221ThresholdPolicy thresholdPolicy{ device };
+    CIna3221ThresholdPolicy::CPolicy policy;
+    policy.iCriticalCurrentA[ 0 ] = 1.0f;
+    policy.iWarningCurrentA[ 0 ] = 0.5f;
+    policy.iUnderVoltageV[ 0 ] = policy.iUnderVoltageV[ 1 ] = policy.iUnderVoltageV[ 2 ] = 4.5f;
+    BenchmarkTransactions( aWriter, "threshold_policy_apply", bus, [ & ]( std::uint32_t ) {
+        return thresholdPolicy.Apply( policy );
+    } );
+    BenchmarkTransactions( aWriter, "threshold_policy_verify", bus, [ & ]( std::uint32_t ) {
+        return thresholdPolicy.Verify( );
+    } );
+
+    // Alternates between two configurations so every write changes the register
+    const auto reconfigure = [ & ]( std::uint32_t aRepetition ) {
+        return device.SetConfig( FastConfig( ).SetAveragingMode(
+            ( aRepetition & 1 ) != 0 ? CIina3221::AveragingMode::avg4
+                                     : CIina3221::AveragingMode::avg16 ) );
+    };
+    const auto reconfigureUnchanged
+        = [ & ]( std::uint32_t ) { return device.SetConfig( FastConfig( ) ); };
+    const auto reconfigureAlerts = [ & ]( std::uint32_t ) {
+        CIina3221::CTransaction transaction{ device };
+        return transaction.SetShuntCriticalAlertLimit( 0.1f, CIina3221::KChannel1 )
+            .SetShuntWarningAlertLimit( 0.05f, CIina3221::KChannel1 )
+            .SetMaskEnable( CIina3221::CMaskEnable{ }.SetWarningLatchEnable( true ) )
+            .SetConfig( FastConfig( ) )
+            .Commit( );
+    };
+
+    BenchmarkTransactions( aWriter, "reconfigure", bus, reconfigure );
+    BenchmarkTransactions( aWriter, "reconfigure_unchanged", bus, reconfigureUnchanged );
+    BenchmarkTransactions( aWriter, "reconfigure_alerts_transaction", bus, reconfigureAlerts );
+
+    device.EnableShadowCache( );
+    BenchmarkTransactions( aWriter, "reconfigure_shadowed", bus, reconfigure );
+    BenchmarkTransactions( aWriter, "reconfigure_unchanged_shadowed", bus, reconfigureUnchanged );
+    BenchmarkTransactions( aWriter,
+                           "reconfigure_alerts_transaction_shadowed",
+                           bus,
+                           reconfigureAlerts );
+
+    aWriter.EndSection( );
+}
+
+void
+BenchmarkEndToEnd( CJsonWriter& aWriter,
+                   std::uint32_t aLatencyNs,
+                   CIina3221::SnapshotReadMode aReadMode,
+                   std::uint32_t aSamples )
+{
+    CSimulatedI2CBus bus{ 400000, aLatencyNs };
+    CIna3221Simulator simulator;
+    bus.Attach( simulator );
+    simulator.SetShuntVoltage( CIina3221::KChannel1, 0.01f );
+    simulator.SetBusVoltage( CIina3221::KChannel1, 12.0f );
+
+    CIina3221 device{ bus };
+    device.iSnapshotReadMode = aReadMode;
+    CIina3221::CMeasurementSnapshot snapshot;
+
+    std::uint64_t failures = 0;
+    if ( device.Init( FastConfig( ) ) != AbstractPlatform::KOk )
+    {
+        ++failures;
+    }
+
+    bus.ResetStatistics( );
+    const auto startNs = bus.NowNs( );
+    const auto start = TClock::now( );
+    std::uint32_t samples = 0;
+    while ( samples < aSamples && failures < aSamples )
+    {
+        if ( device.ReadSnapshotIfReady( snapshot ) != AbstractPlatform::KOk )
+        {
+            ++failures;
+        }
+        else if ( snapshot.iFresh )
+        {
+            ++samples;
+        }
+    }
+    const auto elapsed = std::chrono::duration< double >( TClock::now( ) - start );
+    const double virtualSeconds = static_cast< double >( bus.NowNs( ) - startNs ) / 1e9;
+
+    char name[ 64 ];
+    std::snprintf( name,
+                   sizeof( name ),
+                   "%s_latency_%luns",
+                   aReadMode == CIina3221::SnapshotReadMode::Block ? "block" : "sequential",
+                   static_cast< unsigned long >( aLatencyNs ) );
+    aWriter.BeginEntry( name );
+    aWriter.Field( "latency_ns", static_cast< std::uint64_t >( aLatencyNs ) );
+    aWriter.Field( "samples", static_cast< std::uint64_t >( samples ) );
+    aWriter.Field( "samples_per_s", samples / virtualSeconds );
+    aWriter.Field( "conversion_period_us",
+                   static_cast< std::uint64_t >( CIina3221::ConversionPeriodUs( FastConfig( ) ) ) );
+    aWriter.Field( "transactions_per_sample",
+                   static_cast< double >( bus.Statistics( ).iTransactions ) / samples );
+    aWriter.Field( "host_ns_per_sample", elapsed.count( ) * 1e9 / samples );
+    aWriter.Field( "failures", failures );
+    aWriter.EndEntry( );
+}
+
+void
+RunEndToEndBenchmarks( CJsonWriter& aWriter, std::uint32_t aSamples )
+{
+    aWriter.BeginSection( "end_to_end" );
+    for ( const auto latencyNs : KLatenciesNs )
+    {
+        BenchmarkEndToEnd( aWriter, latencyNs, CIina3221::SnapshotReadMode::Block, aSamples );
+        BenchmarkEndToEnd( aWriter, latencyNs, CIina3221::SnapshotReadMode::Sequential, aSamples );
+    }
+    aWriter.EndSection( );
+}
+
+// Simulated bus whose transactions also take their bus time in real time, so concurrent readers
+// contend as they would on hardware
+class CRealTimeI2CBus : public AbstractPlatform::IAbstractI2CBus
+{
+public:
+    explicit CRealTimeI2CBus( CSimulatedI2CBus& aBus )
+        : iBus{ aBus }
+    {
+    }
+
+    int
+    Read( std::uint8_t aAddress, std::uint8_t* aData, std::size_t aSize, bool aNoStop ) override
+    {
+        const auto startNs = iBus.NowNs( );
+        const auto result = iBus.Read( aAddress, aData, aSize, aNoStop );
+        Wait( iBus.NowNs( ) - startNs );
+        return result;
+    }
+
+    int
+    Write( std::uint8_t aAddress,
+           const std::uint8_t* aData,
+           std::size_t aSize,
+           bool aNoStop ) override
+    {
+        const auto startNs = iBus.NowNs( );
+        const auto result = iBus.Write( aAddress, aData, aSize, aNoStop );
+        Wait( iBus.NowNs( ) - startNs );
+        return result;
+    }
+
+private:
+    CSimulatedI2CBus& iBus;
+
+    static void
+    Wait( std::uint64_t aDurationNs )
+    {
+        const auto end = TClock::now( ) + std::chrono::nanoseconds{ aDurationNs };
+        while ( TClock::now( ) < end )
+        {
+        }
+    }
+};
+
+// aStaleness < 0 selects the baseline: every request reads the bus under one coarse mutex
+void
+BenchmarkSharedDevice( CJsonWriter& aWriter,
+                       std::uint32_t aThreads,
+                       std::chrono::microseconds aStaleness )
+{
+    CSimulatedI2CBus simulatedBus;
+    CIna3221Simulator simulator;
+    simulatedBus.Attach( simulator );
+    simulator.SetShuntVoltage( CIina3221::KChannel1, 0.01f );
+    simulator.SetBusVoltage( CIina3221::KChannel1, 12.0f );
+
+    CRealTimeI2CBus bus{ simulatedBus };
+    CIina3221 device{ bus };
+    const bool baseline = aStaleness.count( ) < 0;
+    CIna3221BusArbiter arbiter;
+    CIna3221SharedDevice shared{ device, arbiter, aStaleness };
+    std::mutex coarseMutex;
+
+    std::uint64_t failures = device.Init( FastConfig( ) ) == AbstractPlatform::KOk ? 0 : 1;
+    simulatedBus.ResetStatistics( );
+
+    std::atomic< bool > running{ true };
+    std::atomic< std::uint64_t > requests{ 0 };
+    std::atomic< std::uint64_t > errors{ 0 };
+    std::vector< std::thread > readers;
+    const auto start = TClock::now( );
+    for ( std::uint32_t thread = 0; thread < aThreads; ++thread )
+    {
+        readers.emplace_back( [ & ]( ) {
+            CIina3221::CMeasurementSnapshot snapshot;
+            std::uint64_t localRequests = 0;
+            std::uint64_t localErrors = 0;
+            while ( running.load( std::memory_order_relaxed ) )
+            {
+                AbstractPlatform::TErrorCode result = AbstractPlatform::KOk;
+                if ( baseline )
+                {
+                    std::lock_guard< std::mutex > lock{ coarseMutex };
+                    result = device.ReadSnapshot( snapshot );
+                }
+                else
+                {
+                    result = shared.ReadSnapshot( snapshot );
+                }
+                ++localRequests;
+                localErrors += result == AbstractPlatform::KOk ? 0 : 1;
+            }
+            requests.fetch_add( localRequests );
+            errors.fetch_add( localErrors );
+        } );
+    }
+    std::this_thread::sleep_for( KSharedDeviceDuration );
+    running.store( false );
+    for ( auto& reader : readers )
+    {
+        reader.join( );
+    }
+    const auto elapsed = std::chrono::duration< double >( TClock::now( ) - start );
+
+    char name[ 64 ];
+    if ( baseline )
+    {
+        std::snprintf( name,
+                       sizeof( name ),
+                       "coarse_mutex_%lu_threads",
+                       static_cast< unsigned long >( aThreads ) );
+    }
+    else
+    {
+        std::snprintf( name,
+                       sizeof( name ),
+                       "shared_%luus_%lu_threads",
+                       static_cast< unsigned long >( aStaleness.count( ) ),
+                       static_cast< unsigned long >( aThreads ) );
+    }
+    const auto statistics = shared.Statistics( );
+    const auto totalRequests = requests.load( );
+    aWriter.BeginEntry( name );
+    aWriter.Field( "threads", static_cast< std::uint64_t >( aThreads ) );
+    aWriter.Field( "requests", totalRequests );
+    aWriter.Field( "requests_per_s", totalRequests / elapsed.count( ) );
+    aWriter.Field( "transactions_per_request",
+                   static_cast< double >( simulatedBus.Statistics( ).iTransactions )
+                       / ( totalRequests != 0 ? totalRequests : 1 ) );
+    aWriter.Field( "cache_hits", statistics.iCacheHits );
+    aWriter.Field( "coalesced", statistics.iCoalesced );
+    aWriter.Field( "failures", failures + errors.load( ) );
+    aWriter.EndEntry( );
+}
+
+void
+RunSharedDeviceBenchmarks( CJsonWriter& aWriter )
+{
+    aWriter.BeginSection( "shared_device" );
+    for ( const auto threads : KReaderThreads )
+    {
+        BenchmarkSharedDevice( aWriter, threads, std::chrono::microseconds{ -1 } );
+        BenchmarkSharedDevice( aWriter, threads, std::chrono::microseconds{ 0 } );
+        BenchmarkSharedDevice( aWriter, threads, std::chrono::microseconds{ 1000 } );
+    }
+    aWriter.EndSection( );
+}
+
+}  // namespace
+
+int
+main( int aArgc, char** aArgv )
+{
+    const std::uint32_t decodeIterations
+        = aArgc > 1 ? static_cast< std::uint32_t >( std::strtoul( aArgv[ 1 ], nullptr, 0 ) )
+                    : KDefaultDecodeIterations;
+    const std::uint32_t endToEndSamples
+        = aArgc > 2 ? static_cast< std::uint32_t >( std::strtoul( aArgv[ 2 ], nullptr, 0 ) )
+                    : KDefaultEndToEndSamples;
+    if ( decodeIterations == 0 || endToEndSamples == 0 )
+    {
+        std::fprintf( stderr, "usage: %s [decode iterations] [end-to-end samples]\n", aArgv[ 0 ] );
+        return EXIT_FAILURE;
+    }
+
+    CJsonWriter writer;
+    writer.Begin( );
+    RunChecks( writer );
+    RunDecodeBenchmarks( writer, decodeIterations );
+    RunBulkDecodeBenchmarks( writer, decodeIterations );
+    RunTransactionBenchmarks( writer );
+    RunEndToEndBenchmarks( writer, endToEndSamples );
+    RunSharedDeviceBenchmarks( writer );
+    writer.End( );
+
+    return gCheckFailures != 0 || gSink == 0x7FFFFFFFFFFFFFFF ? EXIT_FAILURE : EXIT_SUCCESS;
+}